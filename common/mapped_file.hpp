@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+class mapped_file
+{
+public:
+	explicit mapped_file(const char* filename)
+	{
+		const auto descriptor = ::open(filename, O_RDONLY);
+		if (descriptor == -1)
+			return;
+
+		struct stat file_stat;
+		if (::fstat(descriptor, &file_stat) == 0)
+		{
+			size = std::size_t(file_stat.st_size);
+			opened = true;
+
+			if (size != 0)
+			{
+				auto* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+				if (mapping == MAP_FAILED)
+					opened = false;
+				else
+					buffer = static_cast<const char*>(mapping);
+			}
+		}
+
+		::close(descriptor);
+	}
+
+	~mapped_file()
+	{
+		if (buffer != nullptr)
+			::munmap(const_cast<char*>(buffer), size);
+	}
+
+	mapped_file(const mapped_file&) = delete;
+	mapped_file& operator=(const mapped_file&) = delete;
+
+	auto is_open() const -> bool
+	{
+		return opened;
+	}
+
+	auto data() const -> std::string_view
+	{
+		return buffer == nullptr ? std::string_view{} : std::string_view{buffer, size};
+	}
+
+private:
+	const char* buffer = nullptr;
+	std::size_t size = 0;
+	bool opened = false;
+};
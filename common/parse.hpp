@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+inline auto is_space(const char c) -> bool
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline auto next_token(std::string_view& text) -> std::string_view
+{
+	auto begin = std::size_t{0};
+	while (begin < text.size() && is_space(text[begin]))
+		++begin;
+
+	auto end = begin;
+	while (end < text.size() && !is_space(text[end]))
+		++end;
+
+	const auto token = text.substr(begin, end - begin);
+	text.remove_prefix(end);
+
+	return token;
+}
+
+template<typename Integer>
+auto parse_integer(const std::string_view text, Integer& value) -> bool
+{
+	const auto[end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+	return error == std::errc{} && end == text.data() + text.size();
+}
+
+template<typename Integer>
+auto parse_integer_list(const std::string_view text, const char separator) -> std::vector<Integer>
+{
+	std::vector<Integer> values;
+
+	for (auto begin = std::size_t{0}; begin < text.size();)
+	{
+		const auto end = std::min(text.find(separator, begin), text.size());
+
+		auto value = Integer{0};
+		std::from_chars(text.data() + begin, text.data() + end, value);
+		values.push_back(value);
+
+		begin = end + 1;
+	}
+
+	return values;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+struct solution
+{
+	std::string part1;
+	std::string part2;
+
+	std::chrono::steady_clock::duration parse_time{};
+	std::chrono::steady_clock::duration part1_time{};
+	std::chrono::steady_clock::duration part2_time{};
+};
+
+template<typename Function>
+auto time_phase(std::chrono::steady_clock::duration& elapsed, Function function)
+{
+	const auto start = std::chrono::steady_clock::now();
+	auto result = function();
+	elapsed = std::chrono::steady_clock::now() - start;
+	return result;
+}
@@ -1,5 +1,14 @@
 #include <iostream>
 #include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../common/parse.hpp"
+#include "../common/solution.hpp"
+
+namespace day1
+{
 
 constexpr auto fuel_required(long long mass)
 {
@@ -18,6 +27,44 @@ constexpr auto fuel_fuel_required(long long mass)
 	return fuel;
 }
 
+auto solve(const std::string_view input) -> solution
+{
+	solution result;
+
+	const auto masses = time_phase(result.parse_time, [&] {
+		std::vector<long long> masses;
+		auto data = input;
+		long long mass;
+		while (parse_integer(next_token(data), mass))
+			masses.push_back(mass);
+		return masses;
+	});
+
+	result.part1 = time_phase(result.part1_time, [&] {
+		long long modules_fuel = 0;
+		for (const auto mass : masses)
+			modules_fuel += fuel_required(mass);
+		return std::to_string(modules_fuel);
+	});
+
+	result.part2 = time_phase(result.part2_time, [&] {
+		long long total_fuel = 0;
+		for (const auto mass : masses)
+		{
+			const auto module_fuel = fuel_required(mass);
+			total_fuel += module_fuel + fuel_fuel_required(module_fuel);
+		}
+		return std::to_string(total_fuel);
+	});
+
+	return result;
+}
+
+} // namespace day1
+
+#ifndef AOC_RUNNER
+using namespace day1;
+
 int main(int argc, char* argv[])
 {
 	if (argc != 2)
@@ -51,3 +98,4 @@ int main(int argc, char* argv[])
 	
 	return 0;
 }
+#endif
@@ -1,55 +1,56 @@
 #include <algorithm>
-#include <cmath>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
-using asteroid_vector = std::vector<std::pair<double, double>>;
+#include "../common/parse.hpp"
+#include "../common/solution.hpp"
 
-enum class quadrant
+namespace day10
 {
-	first,
-	fourth,
-	third,
-	second
-};
 
-struct asteroid_relative_pos
+using asteroid_vector = std::vector<std::pair<int, int>>;
+
+struct asteroid_map
 {
-	std::pair<double, double> asteroid;
+	int width;
+	int height;
+	std::vector<std::uint64_t> bits;
+	asteroid_vector asteroids;
 
-	double tan;
-	double distance;
-	quadrant quad;
+	auto has_asteroid(const int x, const int y) const -> bool
+	{
+		const auto pos = std::size_t(y) * std::size_t(width) + std::size_t(x);
+		return (bits[pos >> 6] >> (pos & 63)) & 1;
+	}
 
-	explicit asteroid_relative_pos(const std::pair<double, double>& asteroid, const double tan, const double distance, const quadrant quad) :
-		asteroid{asteroid}, tan{tan}, distance{distance}, quad{quad}
-	{}
+	auto set_asteroid(const int x, const int y) -> void
+	{
+		const auto pos = std::size_t(y) * std::size_t(width) + std::size_t(x);
+		bits[pos >> 6] |= std::uint64_t{1} << (pos & 63);
+	}
 
-	bool operator<(const asteroid_relative_pos& r) const
+	auto clear_asteroid(const int x, const int y) -> void
 	{
-		if (quad == r.quad)
-		{
-			if (tan == r.tan)
-				return distance < r.distance;
-		
-			switch (quad)
-			{
-				case quadrant::first:
-				case quadrant::fourth:
-					return r.tan < tan;
-					
-				case quadrant::third:
-				case quadrant::second:
-					return tan < r.tan;
-			}
-		}
-		return quad < r.quad;
+		const auto pos = std::size_t(y) * std::size_t(width) + std::size_t(x);
+		bits[pos >> 6] &= ~(std::uint64_t{1} << (pos & 63));
 	}
 
-	bool operator==(const asteroid_relative_pos& r) const
+	auto contains(const int x, const int y) const -> bool
 	{
-		return (quad == r.quad) && (tan == r.tan);
+		return x >= 0 && x < width && y >= 0 && y < height;
 	}
 };
 
@@ -76,185 +77,647 @@ auto print_asteroid_vector(const asteroid_vector& asteroid_data) -> void
 	std::cout << "]" << std::endl;
 }
 
-auto print_relative_pos(const asteroid_relative_pos& pos) -> void
+auto load_asteroid_data(std::string_view data) -> asteroid_map
 {
-	print_pair(pos.asteroid);
-	std::cout << ": ";
-	switch (pos.quad)
+	asteroid_map map{0, 0, {}, {}};
+
+	std::vector<std::string_view> rows;
+
+	for (auto row_data = next_token(data); !row_data.empty(); row_data = next_token(data))
 	{
-		case quadrant::first: std::cout << "[quadrant: first] "; break;
-		case quadrant::second: std::cout << "[quadrant: second] "; break;
-		case quadrant::third: std::cout << "[quadrant: third] "; break;
-		case quadrant::fourth: std::cout << "[quadrant: fourth] "; break;
+		map.width = std::max(map.width, int(row_data.size()));
+		rows.push_back(row_data);
 	}
-	std::cout << "[tan: " << pos.tan << "] [distance: " << pos.distance << "]";
-}
 
-auto load_asteroid_data(std::ifstream& data_file) -> asteroid_vector
-{
-	asteroid_vector asteroid_data;
+	map.height = int(rows.size());
+	map.bits.assign((std::size_t(map.width) * std::size_t(map.height) + 63) / 64, 0);
 
-	std::string row_data;
-	auto x = 0;
-	auto y = 0;
-	
-	while (data_file >> row_data)
+	for (auto y = 0; y < map.height; ++y)
 	{
-		for (const auto cell : std::as_const(row_data))
+		for (auto x = 0; x < int(rows[y].size()); ++x)
 		{
-			if (cell == '#')
-				asteroid_data.emplace_back(double(x), double(y));
-			++x;
+			if (rows[y][x] == '#')
+			{
+				map.asteroids.emplace_back(x, y);
+				map.set_asteroid(x, y);
+			}
 		}
-		++y;
-		x = 0;
 	}
 
-	return asteroid_data;
+	return map;
 }
 
-constexpr auto get_quadrant(const double x, const double y) -> quadrant
+auto load_asteroid_data(std::ifstream& data_file) -> asteroid_map
 {
-	if (x <= 0.0 && y > 0.0)
-		return quadrant::first;
-	else if (x > 0.0 && y > 0.0)
-		return quadrant::second;
-	else if (x > 0.0 && y <= 0.0)
-		return quadrant::third;
-	return quadrant::fourth;	
+	const std::string data{std::istreambuf_iterator<char>(data_file), std::istreambuf_iterator<char>()};
+	return load_asteroid_data(data);
 }
 
-auto get_asteroid_relative_pos(const std::pair<double, double>& asteroid1, const std::pair<double, double>& asteroid2) -> asteroid_relative_pos
+auto is_visible(const asteroid_map& map, const std::pair<int, int>& from, const std::pair<int, int>& to) -> bool
 {
-	const auto x = asteroid1.first - asteroid2.first;
-	const auto y = asteroid1.second - asteroid2.second;
+	const auto x = to.first - from.first;
+	const auto y = to.second - from.second;
+	const auto divisor = std::gcd(x, y);
+
+	if (divisor == 0)
+		return false;
 
-	const auto tan = y / x;
-	const auto distance = std::sqrt(x * x + y * y);
-	const auto quad = get_quadrant(x, y);
+	const auto step_x = x / divisor;
+	const auto step_y = y / divisor;
+
+	for (auto step = 1; step < divisor; ++step)
+	{
+		if (map.has_asteroid(from.first + step * step_x, from.second + step * step_y))
+			return false;
+	}
 
-	return asteroid_relative_pos(asteroid2, tan, distance, quad);
+	return true;
 }
 
-auto get_detectable_asteroids(const asteroid_vector& asteroid_data) -> std::vector<int>
+auto count_detectable_asteroids(const asteroid_map& map, const std::pair<int, int>& asteroid_checking) -> int
 {
-	std::vector<int> num_detectable_asteroids;
+	auto detectable = 0;
+
+	for (const auto& asteroid_detectable : map.asteroids)
+		detectable += is_visible(map, asteroid_checking, asteroid_detectable);
+
+	return detectable;
+}
 
-	for (const auto& asteroid_checking : asteroid_data)
+struct best_station
+{
+	int index;
+	int detectable;
+	std::pair<int, int> asteroid;
+
+	bool is_better_than(const best_station& r) const
 	{
-		auto detectable_asteroids = 0;
-				
-		for (const auto& asteroid_detectable : asteroid_data)
+		if (detectable == r.detectable)
+			return index < r.index;
+		return detectable > r.detectable;
+	}
+};
+
+auto get_detectable_counts(const asteroid_map& map) -> std::vector<int>
+{
+	const auto num_asteroids = int(map.asteroids.size());
+	const auto num_threads = std::max(1, std::min(int(std::thread::hardware_concurrency()), num_asteroids));
+
+	std::vector<int> detectable(num_asteroids, 0);
+	const auto worker = [&] (const int thread_index) {
+		for (auto i = thread_index; i < num_asteroids; i += num_threads)
+			detectable[i] = count_detectable_asteroids(map, map.asteroids[i]);
+	};
+
+	std::vector<std::thread> threads;
+	for (auto i = 1; i < num_threads; ++i)
+		threads.emplace_back(worker, i);
+
+	worker(0);
+
+	for (auto& thread : threads)
+		thread.join();
+
+	return detectable;
+}
+
+auto get_best_station(const asteroid_map& map, const std::vector<int>& detectable) -> best_station
+{
+	best_station best{-1, -1, {0, 0}};
+
+	for (auto i = 0; i < int(map.asteroids.size()); ++i)
+	{
+		const best_station station{i, detectable[i], map.asteroids[i]};
+		if (station.is_better_than(best))
+			best = station;
+	}
+
+	return best;
+}
+
+auto get_best_station(const asteroid_map& map) -> best_station
+{
+	return get_best_station(map, get_detectable_counts(map));
+}
+
+struct dynamic_asteroid_field
+{
+	asteroid_map map;
+	std::vector<int> detectable;
+};
+
+auto build_dynamic_asteroid_field(asteroid_map map) -> dynamic_asteroid_field
+{
+	auto detectable = get_detectable_counts(map);
+	return dynamic_asteroid_field{std::move(map), std::move(detectable)};
+}
+
+auto is_reading_order_before(const std::pair<int, int>& l, const std::pair<int, int>& r) -> bool
+{
+	return l.second != r.second ? l.second < r.second : l.first < r.first;
+}
+
+auto has_asteroid_on_ray(const asteroid_map& map, const std::pair<int, int>& from, const std::pair<int, int>& to) -> bool
+{
+	const auto x = to.first - from.first;
+	const auto y = to.second - from.second;
+	const auto divisor = std::gcd(x, y);
+	const auto step_x = x / divisor;
+	const auto step_y = y / divisor;
+
+	for (auto pos_x = from.first + step_x, pos_y = from.second + step_y; map.contains(pos_x, pos_y); pos_x += step_x, pos_y += step_y)
+	{
+		if (map.has_asteroid(pos_x, pos_y))
+			return true;
+	}
+
+	return false;
+}
+
+auto update_ray_counts(dynamic_asteroid_field& field, const std::pair<int, int>& asteroid, const int delta) -> void
+{
+	const auto& asteroids = field.map.asteroids;
+
+	for (auto i = 0; i < int(asteroids.size()); ++i)
+	{
+		if (!has_asteroid_on_ray(field.map, asteroids[i], asteroid))
+			field.detectable[i] += delta;
+	}
+}
+
+auto add_asteroid(dynamic_asteroid_field& field, const std::pair<int, int>& asteroid) -> bool
+{
+	auto& map = field.map;
+	if (!map.contains(asteroid.first, asteroid.second) || map.has_asteroid(asteroid.first, asteroid.second))
+		return false;
+
+	update_ray_counts(field, asteroid, 1);
+	map.set_asteroid(asteroid.first, asteroid.second);
+
+	const auto it = std::lower_bound(map.asteroids.begin(), map.asteroids.end(), asteroid, is_reading_order_before);
+	const auto index = it - map.asteroids.begin();
+	map.asteroids.insert(it, asteroid);
+	field.detectable.insert(field.detectable.begin() + index, count_detectable_asteroids(map, asteroid));
+
+	return true;
+}
+
+auto remove_asteroid(dynamic_asteroid_field& field, const std::pair<int, int>& asteroid) -> bool
+{
+	auto& map = field.map;
+	if (!map.contains(asteroid.first, asteroid.second) || !map.has_asteroid(asteroid.first, asteroid.second))
+		return false;
+
+	const auto it = std::lower_bound(map.asteroids.begin(), map.asteroids.end(), asteroid, is_reading_order_before);
+	field.detectable.erase(field.detectable.begin() + (it - map.asteroids.begin()));
+	map.asteroids.erase(it);
+	map.clear_asteroid(asteroid.first, asteroid.second);
+
+	update_ray_counts(field, asteroid, -1);
+
+	return true;
+}
+
+auto apply_asteroid_edits(dynamic_asteroid_field& field, std::ifstream& edits_file) -> void
+{
+	std::string line;
+	while (edits_file >> line)
+	{
+		std::pair<int, int> asteroid;
+		char separator = 0;
+		std::istringstream edit(line.size() < 2 ? std::string() : line.substr(1));
+		if (!(edit >> asteroid.first >> separator >> asteroid.second) || separator != ',')
 		{
-			if (asteroid_detectable == asteroid_checking)
-				continue;
+			std::cerr << "Error! Invalid edit: " << line << std::endl;
+			continue;
+		}
 
-			auto blocked = false;
+		auto applied = false;
+		switch (line[0])
+		{
+			case '+':
+				applied = add_asteroid(field, asteroid);
+				break;
+			case '-':
+				applied = remove_asteroid(field, asteroid);
+				break;
+		}
 
-			const auto detectable_relative_pos = get_asteroid_relative_pos(asteroid_checking, asteroid_detectable);
+		if (!applied)
+			std::cerr << "Error! Cannot apply edit: " << line << std::endl;
 
-			for (const auto& asteroid_blocking : asteroid_data)
-			{
-				if (asteroid_blocking == asteroid_detectable ||
-					asteroid_blocking == asteroid_checking)
-					continue;
-
-				const auto blocking_relative_pos = get_asteroid_relative_pos(asteroid_checking, asteroid_blocking);
-
-				if (blocking_relative_pos == detectable_relative_pos &&
-					blocking_relative_pos.distance < detectable_relative_pos.distance)
-				{
-					blocked = true;
-					break;
-				}
-			}
-			if (!blocked)
-				++detectable_asteroids;
+		const auto station = get_best_station(field.map, field.detectable);
+
+		std::cout << line << ": ";
+		if (station.index == -1)
+		{
+			std::cout << "no asteroids" << std::endl;
+			continue;
 		}
-		num_detectable_asteroids.push_back(detectable_asteroids);
+
+		std::cout << "best position ";
+		print_pair(station.asteroid);
+		std::cout << "detects " << station.detectable << std::endl;
 	}
+}
+
+struct direction_bucket
+{
+	std::pair<int, int> direction;
+	asteroid_vector asteroids;
+};
 
-	return num_detectable_asteroids;
+auto get_direction_half(const std::pair<int, int>& direction) -> int
+{
+	return (direction.first > 0 || (direction.first == 0 && direction.second < 0)) ? 0 : 1;
+}
+
+auto is_clockwise_before(const std::pair<int, int>& l, const std::pair<int, int>& r) -> bool
+{
+	const auto l_half = get_direction_half(l);
+	const auto r_half = get_direction_half(r);
+
+	if (l_half != r_half)
+		return l_half < r_half;
+
+	return std::int64_t{l.first} * r.second - std::int64_t{l.second} * r.first > 0;
+}
+
+auto get_direction_key(const std::pair<int, int>& direction) -> std::uint64_t
+{
+	return (std::uint64_t(std::uint32_t(direction.first)) << 32) | std::uint32_t(direction.second);
 }
 
-auto get_asteroids_relative_pos(const asteroid_vector& asteroid_data, const std::pair<double, double>& asteroid) -> std::vector<asteroid_relative_pos>
+auto get_direction_buckets(const asteroid_map& map, const std::pair<int, int>& station) -> std::vector<direction_bucket>
 {
-	std::vector<asteroid_relative_pos> relative_pos;
+	std::vector<direction_bucket> buckets;
+	std::unordered_map<std::uint64_t, int> bucket_indices;
 
-	for (const auto& asteroid_relative : asteroid_data)
+	for (const auto& asteroid : map.asteroids)
 	{
-		if (asteroid == asteroid_relative)
+		const auto x = asteroid.first - station.first;
+		const auto y = asteroid.second - station.second;
+		const auto divisor = std::gcd(x, y);
+
+		if (divisor == 0)
 			continue;
 
-		relative_pos.push_back(get_asteroid_relative_pos(asteroid, asteroid_relative));
+		const auto direction = std::pair<int, int>{x / divisor, y / divisor};
+		const auto[it, inserted] = bucket_indices.emplace(get_direction_key(direction), int(buckets.size()));
+
+		if (inserted)
+			buckets.push_back({direction, {}});
+
+		buckets[it->second].asteroids.push_back(asteroid);
 	}
-	
-	return relative_pos;
+
+	for (auto& bucket : buckets)
+	{
+		std::sort(bucket.asteroids.begin(), bucket.asteroids.end(), [&station] (const auto& l, const auto& r) {
+			return std::abs(l.first - station.first) + std::abs(l.second - station.second) <
+				   std::abs(r.first - station.first) + std::abs(r.second - station.second);
+		});
+	}
+
+	return buckets;
 }
 
-template<typename Type>
-auto vector_vectors_to_vector(const std::vector<std::vector<Type>>& vector_vectors) -> std::vector<Type>
+auto get_kth_vaporized_asteroid(const std::vector<direction_bucket>& buckets, int k) -> std::optional<std::pair<int, int>>
 {
-	std::vector<Type> vector;
+	if (k <= 0)
+		return std::nullopt;
 
-	for (const auto& current_vector : vector_vectors)
+	auto max_size = std::size_t{0};
+	for (const auto& bucket : buckets)
+		max_size = std::max(max_size, bucket.asteroids.size());
+
+	std::vector<int> buckets_with_size(max_size + 1, 0);
+	for (const auto& bucket : buckets)
+		buckets_with_size[bucket.asteroids.size()]++;
+
+	auto active_buckets = int(buckets.size());
+	for (auto round = std::size_t{0}; round < max_size; ++round)
 	{
-		for (const Type& element : current_vector)
-			vector.push_back(element);
+		active_buckets -= buckets_with_size[round];
+
+		if (k > active_buckets)
+		{
+			k -= active_buckets;
+			continue;
+		}
+
+		std::vector<const direction_bucket*> round_buckets;
+		round_buckets.reserve(active_buckets);
+		for (const auto& bucket : buckets)
+		{
+			if (bucket.asteroids.size() > round)
+				round_buckets.push_back(&bucket);
+		}
+
+		const auto kth = round_buckets.begin() + (k - 1);
+		std::nth_element(round_buckets.begin(), kth, round_buckets.end(), [] (const auto* l, const auto* r) {
+			return is_clockwise_before(l->direction, r->direction);
+		});
+
+		return (*kth)->asteroids[round];
 	}
 
-	return vector;
+	return std::nullopt;
 }
 
-auto print_rel_pos_vector(const std::vector<asteroid_relative_pos>& vector) -> void
+struct direction_table
 {
-	for (const auto& element : vector)
+	int width;
+	int height;
+	int num_ranks;
+	std::vector<int> ranks;
+
+	auto get_rank(const int x, const int y) const -> int
 	{
-		std::cout << " * ";
-		print_relative_pos(element);
-		std::cout << std::endl;
+		return ranks[std::size_t(y + height - 1) * std::size_t(2 * width - 1) + std::size_t(x + width - 1)];
+	}
+};
+
+auto build_direction_table(const int width, const int height) -> direction_table
+{
+	direction_table table{width, height, 0, std::vector<int>(std::size_t(2 * width - 1) * std::size_t(2 * height - 1), -1)};
+
+	asteroid_vector directions;
+	for (auto y = 1 - height; y < height; ++y)
+	{
+		for (auto x = 1 - width; x < width; ++x)
+		{
+			if (std::gcd(x, y) == 1)
+				directions.emplace_back(x, y);
+		}
+	}
+
+	std::sort(directions.begin(), directions.end(), is_clockwise_before);
+	table.num_ranks = int(directions.size());
+
+	std::vector<int> direction_ranks(table.ranks.size(), -1);
+	for (auto rank = 0; rank < int(directions.size()); ++rank)
+	{
+		const auto[x, y] = directions[rank];
+		direction_ranks[std::size_t(y + height - 1) * std::size_t(2 * width - 1) + std::size_t(x + width - 1)] = rank;
+	}
+
+	for (auto y = 1 - height; y < height; ++y)
+	{
+		for (auto x = 1 - width; x < width; ++x)
+		{
+			const auto divisor = std::gcd(x, y);
+			if (divisor != 0)
+				table.ranks[std::size_t(y + height - 1) * std::size_t(2 * width - 1) + std::size_t(x + width - 1)] =
+					direction_ranks[std::size_t(y / divisor + height - 1) * std::size_t(2 * width - 1) + std::size_t(x / divisor + width - 1)];
+		}
+	}
+
+	return table;
+}
+
+constexpr auto rank_digit_bits = 8;
+constexpr auto rank_digit_size = 1 << rank_digit_bits;
+
+struct vaporization_buffers
+{
+	std::vector<int> ranks;
+	std::vector<int> indices;
+	std::vector<int> sorted_ranks;
+	std::vector<int> sorted_indices;
+	std::vector<int> rounds;
+	std::vector<int> round_offsets;
+	asteroid_vector order;
+};
+
+auto sort_by_rank(const int num_ranks, vaporization_buffers& buffers) -> void
+{
+	const auto num_entries = buffers.ranks.size();
+	buffers.sorted_ranks.resize(num_entries);
+	buffers.sorted_indices.resize(num_entries);
+
+	for (auto shift = 0; ((num_ranks - 1) >> shift) > 0; shift += rank_digit_bits)
+	{
+		std::array<int, rank_digit_size + 1> digit_offsets{};
+		for (const auto rank : buffers.ranks)
+			digit_offsets[((rank >> shift) & (rank_digit_size - 1)) + 1]++;
+
+		std::partial_sum(digit_offsets.begin(), digit_offsets.end(), digit_offsets.begin());
+
+		for (auto i = std::size_t{0}; i < num_entries; ++i)
+		{
+			const auto position = digit_offsets[(buffers.ranks[i] >> shift) & (rank_digit_size - 1)]++;
+			buffers.sorted_ranks[position] = buffers.ranks[i];
+			buffers.sorted_indices[position] = buffers.indices[i];
+		}
+
+		std::swap(buffers.ranks, buffers.sorted_ranks);
+		std::swap(buffers.indices, buffers.sorted_indices);
 	}
 }
 
-auto get_ordered_vaporized_asteroids(const asteroid_vector& asteroid_data, const std::pair<double, double> asteroid) -> asteroid_vector
+auto get_vaporization_order(const asteroid_map& map, const direction_table& table, const std::pair<int, int>& station,
+							vaporization_buffers& buffers) -> const asteroid_vector&
 {
-	auto relative_pos = get_asteroids_relative_pos(asteroid_data, asteroid);
+	buffers.ranks.clear();
+	buffers.indices.clear();
 
-	/*std::cout << "Unsorted relative pos:" << std::endl;
-	print_rel_pos_vector(relative_pos);*/
+	for (auto i = 0; i < int(map.asteroids.size()); ++i)
+	{
+		const auto x = map.asteroids[i].first - station.first;
+		const auto y = map.asteroids[i].second - station.second;
 
-	std::sort(relative_pos.begin(), relative_pos.end());
+		if (x != 0 || y != 0)
+		{
+			buffers.ranks.push_back(table.get_rank(x, y));
+			buffers.indices.push_back(i);
+		}
+	}
 
-	/*std::cout << "Sorted relative pos:" << std::endl;
-	print_rel_pos_vector(relative_pos);*/
+	// A stable radix sort on the direction rank keeps the reading order of
+	// each ray, so every ray holds its asteroids sorted by distance: nearest
+	// first when it points down or right, farthest first when it points up
+	// or left.
+	sort_by_rank(table.num_ranks, buffers);
 
-	std::vector<asteroid_vector> asteroid_vectors;
-	auto prev_asteroid = asteroid_relative_pos(asteroid, 0.0, 0.0, quadrant::second);
-	auto round = 0;
+	const auto num_entries = buffers.ranks.size();
+	buffers.rounds.resize(num_entries);
+	buffers.round_offsets.assign(1, 0);
 
-	asteroid_vectors.emplace_back();
-	
-	for (const auto& asteroid_relative_pos : std::as_const(relative_pos))
+	for (auto begin = std::size_t{0}; begin < num_entries;)
+	{
+		auto end = begin + 1;
+		while (end < num_entries && buffers.ranks[end] == buffers.ranks[begin])
+			++end;
+
+		const auto& first = map.asteroids[buffers.indices[begin]];
+		const auto reversed = first.second < station.second || (first.second == station.second && first.first < station.first);
+		const auto group_size = int(end - begin);
+
+		if (int(buffers.round_offsets.size()) <= group_size)
+			buffers.round_offsets.resize(group_size + 1, 0);
+
+		for (auto i = begin; i < end; ++i)
+		{
+			const auto position = int(i - begin);
+			buffers.rounds[i] = reversed ? group_size - 1 - position : position;
+			buffers.round_offsets[buffers.rounds[i] + 1]++;
+		}
+
+		begin = end;
+	}
+
+	std::partial_sum(buffers.round_offsets.begin(), buffers.round_offsets.end(), buffers.round_offsets.begin());
+
+	buffers.order.resize(num_entries);
+	for (auto i = std::size_t{0}; i < num_entries; ++i)
+		buffers.order[buffers.round_offsets[buffers.rounds[i]]++] = map.asteroids[buffers.indices[i]];
+
+	return buffers.order;
+}
+
+struct vaporization_result
+{
+	std::pair<int, int> station;
+	std::vector<std::optional<std::pair<int, int>>> asteroids;
+};
+
+auto get_vaporized_asteroids(const asteroid_map& map, const asteroid_vector& stations, const std::vector<int>& ks) -> std::vector<vaporization_result>
+{
+	const auto table = build_direction_table(map.width, map.height);
+
+	const auto num_stations = int(stations.size());
+	const auto num_threads = std::max(1, std::min(int(std::thread::hardware_concurrency()), num_stations));
+
+	std::vector<vaporization_result> results(num_stations);
+	const auto worker = [&] (const int thread_index) {
+		vaporization_buffers buffers;
+		for (auto i = thread_index; i < num_stations; i += num_threads)
+		{
+			const auto& order = get_vaporization_order(map, table, stations[i], buffers);
+
+			auto& result = results[i];
+			result.station = stations[i];
+			for (const auto k : ks)
+			{
+				if (k >= 1 && k <= int(order.size()))
+					result.asteroids.emplace_back(order[k - 1]);
+				else
+					result.asteroids.emplace_back(std::nullopt);
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (auto i = 1; i < num_threads; ++i)
+		threads.emplace_back(worker, i);
+
+	worker(0);
+
+	for (auto& thread : threads)
+		thread.join();
+
+	return results;
+}
+
+auto parse_int_list(const std::string& list, std::vector<int>& values) -> bool
+{
+	std::istringstream list_stream(list);
+	std::string value;
+
+	while (std::getline(list_stream, value, ','))
+	{
+		std::istringstream value_stream(value);
+		auto parsed = 0;
+		if (!(value_stream >> parsed) || !value_stream.eof())
+			return false;
+		values.push_back(parsed);
+	}
+
+	return !values.empty();
+}
+
+auto run_vaporize(const asteroid_map& map, int argc, char* argv[]) -> int
+{
+	std::vector<int> ks;
+	if (!parse_int_list(argv[3], ks))
+	{
+		std::cerr << "Error! Invalid vaporization counts: " << argv[3] << std::endl;
+		return -1;
+	}
+
+	auto stations = map.asteroids;
+	if (argc > 4)
+	{
+		stations.clear();
+		for (auto i = 4; i < argc; ++i)
+		{
+			std::vector<int> position;
+			if (!parse_int_list(argv[i], position) || position.size() != 2 || !map.contains(position[0], position[1]))
+			{
+				std::cerr << "Error! Invalid station: " << argv[i] << std::endl;
+				return -1;
+			}
+			stations.emplace_back(position[0], position[1]);
+		}
+	}
+
+	for (const auto& result : get_vaporized_asteroids(map, stations, ks))
 	{
-		if (prev_asteroid == asteroid_relative_pos)
+		print_pair(result.station);
+		for (auto i = std::size_t{0}; i < ks.size(); ++i)
 		{
-			++round;
-			if (int(asteroid_vectors.size()) >= round)
-				asteroid_vectors.emplace_back();
+			std::cout << ks[i] << ": ";
+			if (result.asteroids[i])
+				print_pair(*result.asteroids[i]);
+			else
+				std::cout << "none ";
 		}
-		else
-			round = 0;
-			
-		asteroid_vectors[round].push_back(asteroid_relative_pos.asteroid);
-		prev_asteroid = asteroid_relative_pos;
+		std::cout << std::endl;
 	}
 
-	return vector_vectors_to_vector(asteroid_vectors);
+	return 0;
 }
 
+auto solve(const std::string_view input) -> solution
+{
+	solution result;
+
+	const auto map = time_phase(result.parse_time, [&] {
+		return load_asteroid_data(input);
+	});
+
+	if (map.asteroids.empty())
+		return result;
+
+	best_station station;
+
+	result.part1 = time_phase(result.part1_time, [&] {
+		station = get_best_station(map);
+		return std::to_string(station.detectable);
+	});
+
+	result.part2 = time_phase(result.part2_time, [&] {
+		const auto vaporized_asteroid = get_kth_vaporized_asteroid(get_direction_buckets(map, station.asteroid), 200);
+		if (!vaporized_asteroid)
+			return std::string("none");
+		return std::to_string(100 * vaporized_asteroid->first + vaporized_asteroid->second);
+	});
+
+	return result;
+}
+
+} // namespace day10
+
+#ifndef AOC_RUNNER
+using namespace day10;
+
 int main(int argc, char* argv[])
 {
-	if (argc < 2)
+	const auto edits = (argc == 4 && std::string(argv[2]) == "--edits");
+	const auto vaporize = (argc >= 4 && std::string(argv[2]) == "--vaporize");
+
+	if (argc != 2 && !edits && !vaporize)
 	{
 		std::cerr << "Error! An input file is required!" << std::endl;
 		return -1;
@@ -268,30 +731,55 @@ int main(int argc, char* argv[])
 		return -1;
 	}
 
-	const auto asteroid_data = load_asteroid_data(data_file);
+	auto map = load_asteroid_data(data_file);
 
-	//print_asteroid_vector(asteroid_data);
+	if (vaporize)
+		return run_vaporize(map, argc, argv);
+
+	if (edits)
+	{
+		std::ifstream edits_file(argv[3]);
 
-	const auto num_detectable_asteroids = get_detectable_asteroids(asteroid_data);
+		if (!edits_file.is_open())
+		{
+			std::cerr << "Error! Cannot open file: " << argv[3] << std::endl;
+			return -1;
+		}
 
-	//print_container(num_detectable_asteroids);
+		auto field = build_dynamic_asteroid_field(std::move(map));
+		apply_asteroid_edits(field, edits_file);
+		return 0;
+	}
+
+	const auto& asteroid_data = map.asteroids;
+
+	//print_asteroid_vector(asteroid_data);
+
+	if (asteroid_data.empty())
+	{
+		std::cerr << "Error! No asteroids found in: " << argv[1] << std::endl;
+		return -1;
+	}
 
-	const auto max_detectable = std::max_element(num_detectable_asteroids.begin(), num_detectable_asteroids.end());
+	const auto station = get_best_station(map);
 
-	std::cout << "Detectable asteroids from best position: " << *max_detectable << std::endl;
+	std::cout << "Detectable asteroids from best position: " << station.detectable << std::endl;
 
-	const auto asteroid = asteroid_data.at(std::distance(num_detectable_asteroids.begin(), max_detectable));
+	const auto asteroid = station.asteroid;
 
 	/*std::cout << "Best position asteroid: ";
 	print_pair(asteroid);
 	std::cout << std::endl;*/
 
-	const auto vaporized_asteroids = get_ordered_vaporized_asteroids(asteroid_data, asteroid);
-	//print_asteroid_vector(vaporized_asteroids);
+	const auto vaporized_asteroid = get_kth_vaporized_asteroid(get_direction_buckets(map, asteroid), 200);
 
 	std::cout << "200th asteroid to be vaporized: ";
-	print_pair(vaporized_asteroids[199]);
+	if (vaporized_asteroid)
+		print_pair(*vaporized_asteroid);
+	else
+		std::cout << "none";
 	std::cout << std::endl;
 	
 	return 0;
 }
+#endif
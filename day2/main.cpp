@@ -1,19 +1,18 @@
 #include <iostream>
 #include <fstream>
-#include <sstream>
+#include <string>
+#include <string_view>
 #include <vector>
 
-auto load_program(const std::string& data) -> std::vector<int>
+#include "../common/parse.hpp"
+#include "../common/solution.hpp"
+
+namespace day2
 {
-	std::vector<int> program;
 
-	std::stringstream ss_data(data);
-	std::string int_data;
-	
-	while (std::getline(ss_data, int_data, ',')) 
-		program.push_back(std::stoi(int_data));
-	
-	return program;
+auto load_program(const std::string_view data) -> std::vector<int>
+{
+	return parse_integer_list<int>(data, ',');
 }
 
 auto add(std::vector<int>& memory, int& pc) -> void
@@ -79,6 +78,44 @@ auto find_result(const int result, const std::vector<int>& memory, int& noun, in
 	return false;
 }
 
+constexpr auto gravity_assist_output = 19690720;
+
+auto solve(const std::string_view input) -> solution
+{
+	solution result;
+
+	const auto memory = time_phase(result.parse_time, [&] {
+		auto data = input;
+		return load_program(next_token(data));
+	});
+
+	if (memory.size() < 3)
+		return result;
+
+	result.part1 = time_phase(result.part1_time, [&] {
+		auto memory_copy = memory;
+		memory_copy[1] = 12;
+		memory_copy[2] = 2;
+		run_program(memory_copy);
+		return std::to_string(memory_copy[0]);
+	});
+
+	result.part2 = time_phase(result.part2_time, [&] {
+		int noun;
+		int verb;
+		if (!find_result(gravity_assist_output, memory, noun, verb))
+			return std::string("none");
+		return std::to_string(100 * noun + verb);
+	});
+
+	return result;
+}
+
+} // namespace day2
+
+#ifndef AOC_RUNNER
+using namespace day2;
+
 int main(int argc, char* argv[])
 {
 	if (argc < 2)
@@ -125,3 +162,4 @@ int main(int argc, char* argv[])
 	
 	return 0;
 }
+#endif
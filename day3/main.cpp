@@ -1,11 +1,29 @@
 #include <algorithm>
+#include <cstdint>
+#include <atomic>
+#include <charconv>
 #include <iostream>
 #include <fstream>
+#include <functional>
 #include <limits>
+#include <map>
+#include <mutex>
+#include <numeric>
 #include <optional>
-#include <sstream>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
+#include "../common/parse.hpp"
+#include "../common/solution.hpp"
+
+namespace day3
+{
+
 auto get_inc_from_direction(const char direction) -> std::pair<int, int>
 {
 	switch (direction)
@@ -22,9 +40,10 @@ auto get_inc_from_direction(const char direction) -> std::pair<int, int>
 	return {0, 0};
 }
 
-auto add_next_section(const std::string& section, std::vector<std::pair<int, int>>& wire) -> void
+auto add_next_section(const std::string_view section, std::vector<std::pair<int, int>>& wire) -> void
 {
-	const auto size = std::stoi(section.substr(1));
+	auto size = 0;
+	std::from_chars(section.data() + 1, section.data() + section.size(), size);
 	const auto direction = section[0];		
 
 	const auto[inc_x, inc_y] = get_inc_from_direction(direction);
@@ -34,190 +53,832 @@ auto add_next_section(const std::string& section, std::vector<std::pair<int, int
 					  size * inc_y + last_point.second);
 }
 
-auto get_wire_vector(const std::string& wire_raw) -> std::vector<std::pair<int, int>>
+auto get_wire_vector(const std::string_view wire_raw) -> std::vector<std::pair<int, int>>
 {
 	std::vector<std::pair<int, int>> wire;
 
-	std::stringstream ss_wire_raw(wire_raw);
-	std::string section;
-
 	wire.emplace_back(0, 0);
 
-	while (std::getline(ss_wire_raw, section, ','))
-		add_next_section(section, wire);
+	for (auto begin = std::size_t{0}; begin < wire_raw.size();)
+	{
+		const auto end = std::min(wire_raw.find(',', begin), wire_raw.size());
+		if (end > begin)
+			add_next_section(wire_raw.substr(begin, end - begin), wire);
+		begin = end + 1;
+	}
 
 	return wire;
 }
 
-auto get_intersection_points(const std::pair<int, int>& wire1_start, const std::pair<int, int>& wire1_end,
-							 const std::pair<int, int>& wire2_start, const std::pair<int, int>& wire2_end) -> std::vector<std::pair<int, int>>
+struct axis_segments
+{
+	std::vector<int> fixed;
+	std::vector<int> lo;
+	std::vector<int> hi;
+	std::vector<int> index;
+
+	auto size() const -> int
+	{
+		return int(fixed.size());
+	}
+
+	auto push_back(const int segment_fixed, const int segment_lo, const int segment_hi, const int segment_index) -> void
+	{
+		fixed.push_back(segment_fixed);
+		lo.push_back(segment_lo);
+		hi.push_back(segment_hi);
+		index.push_back(segment_index);
+	}
+};
+
+struct bounding_box
+{
+	int min_x;
+	int max_x;
+	int min_y;
+	int max_y;
+};
+
+struct wire_segments
+{
+	axis_segments horizontals;
+	axis_segments verticals;
+	std::vector<std::pair<int, int>> starts;
+	std::vector<int> steps;
+	bounding_box box;
+	int length;
+};
+
+struct intersection
+{
+	std::pair<int, int> point;
+	int wire1_segment;
+	int wire2_segment;
+};
+
+auto get_points_distance(const std::pair<int, int>& point1, const std::pair<int, int>& point2) -> int
+{
+	return std::abs(point1.first - point2.first) + std::abs(point1.second - point2.second);
+}
+
+auto get_wire_segments(const std::vector<std::pair<int, int>>& wire) -> wire_segments
 {
-	if (wire1_start.first == wire1_end.first)
+	wire_segments segments;
+	auto steps = 0;
+
+	segments.box = {wire.front().first, wire.front().first, wire.front().second, wire.front().second};
+
+	for (auto i = std::size_t{1}; i < wire.size(); ++i)
 	{
-		if (wire2_start.first == wire2_end.first)
+		const auto& start = wire[i - 1];
+		const auto& end = wire[i];
+		const auto index = int(i - 1);
+
+		if (start.second == end.second)
 		{
-			if (wire1_start.first == wire2_start.first)
-			{
-				const auto[w1_min_pos, w1_max_pos] = std::minmax(wire1_start.second, wire1_end.second);
-				const auto[w2_min_pos, w2_max_pos] = std::minmax(wire2_start.second, wire2_end.second);
-				const auto start_pos = std::max(w1_min_pos, w2_min_pos);
-				const auto end_pos = std::min(w1_max_pos, w2_max_pos);
-
-				std::vector<std::pair<int, int>> result;
-				for (auto i = start_pos; i <= end_pos; ++i)
-					result.emplace_back(wire1_start.first, i);
-				return result;	
-			}
+			const auto[min_x, max_x] = std::minmax(start.first, end.first);
+			segments.horizontals.push_back(start.second, min_x, max_x, index);
 		}
 		else
 		{
-			const auto[w1_min_pos, w1_max_pos] = std::minmax(wire1_start.second, wire1_end.second);
-			const auto[w2_min_pos, w2_max_pos] = std::minmax(wire2_start.first, wire2_end.first);
-			if (w1_min_pos <= wire2_start.second && w1_max_pos >= wire2_start.second &&
-				w2_min_pos <= wire1_start.first && w2_max_pos >= wire1_start.first)
-				return {{wire1_start.first, wire2_start.second}};
+			const auto[min_y, max_y] = std::minmax(start.second, end.second);
+			segments.verticals.push_back(start.first, min_y, max_y, index);
 		}
+
+		segments.starts.push_back(start);
+		segments.steps.push_back(steps);
+		steps += get_points_distance(start, end);
+
+		segments.box.min_x = std::min(segments.box.min_x, end.first);
+		segments.box.max_x = std::max(segments.box.max_x, end.first);
+		segments.box.min_y = std::min(segments.box.min_y, end.second);
+		segments.box.max_y = std::max(segments.box.max_y, end.second);
+	}
+
+	segments.length = steps;
+
+	return segments;
+}
+
+enum class sweep_event_type
+{
+	insert,
+	query,
+	remove
+};
+
+struct sweep_event
+{
+	int x;
+	sweep_event_type type;
+	int index;
+
+	bool operator<(const sweep_event& r) const
+	{
+		if (x == r.x)
+			return type < r.type;
+		return x < r.x;
 	}
+};
+
+auto add_intersection(const std::pair<int, int>& point, const int segment, const int other_segment, const bool from_wire1,
+					  std::vector<intersection>& intersections) -> void
+{
+	if (from_wire1)
+		intersections.push_back({point, segment, other_segment});
 	else
+		intersections.push_back({point, other_segment, segment});
+}
+
+auto get_segments_in_range(const axis_segments& segments, const int min_fixed, const int max_fixed,
+						   const int min_pos, const int max_pos) -> axis_segments
+{
+	const auto num_segments = segments.size();
+	std::vector<std::uint8_t> candidates(num_segments);
+
+	const auto* fixed = segments.fixed.data();
+	const auto* lo = segments.lo.data();
+	const auto* hi = segments.hi.data();
+
+	for (auto i = 0; i < num_segments; ++i)
+		candidates[i] = (fixed[i] >= min_fixed) & (fixed[i] <= max_fixed) & (lo[i] <= max_pos) & (hi[i] >= min_pos);
+
+	axis_segments result;
+	for (auto i = 0; i < num_segments; ++i)
+	{
+		if (candidates[i])
+			result.push_back(fixed[i], lo[i], hi[i], segments.index[i]);
+	}
+
+	return result;
+}
+
+auto get_horizontals_in_box(const axis_segments& horizontals, const bounding_box& box) -> axis_segments
+{
+	return get_segments_in_range(horizontals, box.min_y, box.max_y, box.min_x, box.max_x);
+}
+
+auto get_verticals_in_box(const axis_segments& verticals, const bounding_box& box) -> axis_segments
+{
+	return get_segments_in_range(verticals, box.min_x, box.max_x, box.min_y, box.max_y);
+}
+
+template<typename Function>
+auto for_each_crossing_point(const axis_segments& horizontals, const axis_segments& verticals, Function function) -> void
+{
+	std::vector<sweep_event> events;
+	events.reserve(2 * horizontals.size() + verticals.size());
+
+	for (auto i = 0; i < horizontals.size(); ++i)
 	{
-		if (wire2_start.second == wire2_end.second)
+		events.push_back({horizontals.lo[i], sweep_event_type::insert, i});
+		events.push_back({horizontals.hi[i], sweep_event_type::remove, i});
+	}
+
+	for (auto i = 0; i < verticals.size(); ++i)
+		events.push_back({verticals.fixed[i], sweep_event_type::query, i});
+
+	std::sort(events.begin(), events.end());
+
+	std::multiset<std::pair<int, int>> active_horizontals;
+
+	for (const auto& event : events)
+	{
+		switch (event.type)
 		{
-			if (wire1_start.second == wire2_start.second)
+			case sweep_event_type::insert:
+				active_horizontals.emplace(horizontals.fixed[event.index], horizontals.index[event.index]);
+				break;
+
+			case sweep_event_type::remove:
+				active_horizontals.erase(active_horizontals.find({horizontals.fixed[event.index], horizontals.index[event.index]}));
+				break;
+
+			case sweep_event_type::query:
 			{
-				const auto[w1_min_pos, w1_max_pos] = std::minmax(wire1_start.first, wire1_end.first);
-				const auto[w2_min_pos, w2_max_pos] = std::minmax(wire2_start.first, wire2_end.first);
-				const auto start_pos = std::max(w1_min_pos, w2_min_pos);
-				const auto end_pos = std::min(w1_max_pos, w2_max_pos);
-
-				std::vector<std::pair<int, int>> result;
-				for (auto i = start_pos; i <= end_pos; ++i)
-					result.emplace_back(i, wire1_start.second);
-				return result;
+				const auto x = verticals.fixed[event.index];
+				const auto max_y = verticals.hi[event.index];
+				const auto first = std::pair<int, int>{verticals.lo[event.index], std::numeric_limits<int>::min()};
+
+				for (auto it = active_horizontals.lower_bound(first); it != active_horizontals.end() && it->first <= max_y; ++it)
+					function(std::pair<int, int>{x, it->first}, it->second, verticals.index[event.index]);
+				break;
 			}
 		}
-		else
+	}
+}
+
+auto get_crossing_points(const axis_segments& horizontals, const axis_segments& verticals,
+						 const bool horizontals_from_wire1, std::vector<intersection>& intersections) -> void
+{
+	for_each_crossing_point(horizontals, verticals, [&] (const std::pair<int, int>& point, const int horizontal, const int vertical) {
+		add_intersection(point, horizontal, vertical, horizontals_from_wire1, intersections);
+	});
+}
+
+auto get_overlapping_points(const axis_segments& wire1_segments, const axis_segments& wire2_segments,
+							const bool horizontal, std::vector<intersection>& intersections) -> void
+{
+	const axis_segments* wires[2] = {&wire1_segments, &wire2_segments};
+
+	std::vector<std::pair<int, int>> order;
+	order.reserve(wire1_segments.size() + wire2_segments.size());
+
+	for (auto wire_index = 0; wire_index < 2; ++wire_index)
+	{
+		for (auto i = 0; i < wires[wire_index]->size(); ++i)
+			order.emplace_back(wire_index, i);
+	}
+
+	std::sort(order.begin(), order.end(), [&wires] (const auto& l, const auto& r) {
+		const auto& l_wire = *wires[l.first];
+		const auto& r_wire = *wires[r.first];
+		return std::tie(l_wire.fixed[l.second], l_wire.lo[l.second]) < std::tie(r_wire.fixed[r.second], r_wire.lo[r.second]);
+	});
+
+	std::multiset<std::pair<int, int>> active_segments[2];
+	auto current_fixed = std::numeric_limits<int>::min();
+
+	for (const auto&[wire_index, i] : order)
+	{
+		const auto& wire = *wires[wire_index];
+		const auto fixed = wire.fixed[i];
+		const auto lo = wire.lo[i];
+		const auto hi = wire.hi[i];
+
+		if (fixed != current_fixed)
+		{
+			active_segments[0].clear();
+			active_segments[1].clear();
+			current_fixed = fixed;
+		}
+
+		for (auto& active : active_segments)
+		{
+			while (!active.empty() && active.begin()->first < lo)
+				active.erase(active.begin());
+		}
+
+		for (const auto&[other_hi, other_index] : active_segments[1 - wire_index])
 		{
-			const auto[w1_min_pos, w1_max_pos] = std::minmax(wire1_start.first, wire1_end.first);
-			const auto[w2_min_pos, w2_max_pos] = std::minmax(wire2_start.second, wire2_end.second);
-			if (w1_min_pos <= wire2_start.first && w1_max_pos >= wire2_start.first &&
-				w2_min_pos <= wire1_start.second && w2_max_pos >= wire1_start.second)
-				return {{wire2_start.first, wire1_start.second}};
+			const auto end_pos = std::min(other_hi, hi);
+			for (auto pos = lo; pos <= end_pos; ++pos)
+			{
+				const auto point = horizontal ? std::pair<int, int>{pos, fixed} : std::pair<int, int>{fixed, pos};
+				add_intersection(point, wire.index[i], other_index, wire_index == 0, intersections);
+			}
 		}
+
+		active_segments[wire_index].emplace(hi, wire.index[i]);
 	}
-	
-	return {};
 }
 
-auto get_intersections(const std::vector<std::pair<int, int>>& wire1, const std::vector<std::pair<int, int>>& wire2) ->
-	std::vector<std::pair<int, int>>
+auto remove_central_port(std::vector<intersection>& intersections) -> void
 {
-	std::vector<std::pair<int, int>> intersections;
+	const auto central_port = std::pair<int, int>{0, 0};
+	intersections.erase(std::remove_if(intersections.begin(), intersections.end(),
+		[&central_port] (const intersection& intersection) {
+			return intersection.point == central_port;
+		}), intersections.end());
+}
 
-	auto wire1_previous = wire1.front();
-	auto wire2_previous = wire2.front();
+auto get_sweep_intersections(const wire_segments& wire1, const wire_segments& wire2) -> std::vector<intersection>
+{
+	std::vector<intersection> intersections;
 
-	std::for_each(++wire1.begin(), wire1.end(), [&] (const std::pair<int, int>& wire1_point) {
-	
-		std::for_each(++wire2.begin(), wire2.end(), [&] (const std::pair<int, int>& wire2_point) {
-		
-			const auto new_intersections = get_intersection_points(wire1_previous, wire1_point, wire2_previous, wire2_point);
-			std::copy(new_intersections.begin(), new_intersections.end(), std::back_inserter(intersections));
-			
-			wire2_previous = wire2_point;
-		});
-		
-		wire1_previous = wire1_point;
-		wire2_previous = wire2.front();
-	});
+	const auto wire1_horizontals = get_horizontals_in_box(wire1.horizontals, wire2.box);
+	const auto wire1_verticals = get_verticals_in_box(wire1.verticals, wire2.box);
+	const auto wire2_horizontals = get_horizontals_in_box(wire2.horizontals, wire1.box);
+	const auto wire2_verticals = get_verticals_in_box(wire2.verticals, wire1.box);
+
+	get_crossing_points(wire1_horizontals, wire2_verticals, true, intersections);
+	get_crossing_points(wire2_horizontals, wire1_verticals, false, intersections);
+	get_overlapping_points(wire1_horizontals, wire2_horizontals, true, intersections);
+	get_overlapping_points(wire1_verticals, wire2_verticals, false, intersections);
+
+	remove_central_port(intersections);
+
+	return intersections;
+}
+
+constexpr auto grid_tile_bits = 6;
+constexpr auto grid_tile_size = 1 << grid_tile_bits;
+constexpr auto grid_max_cells_per_segment = 64;
+constexpr auto grid_max_cells = std::int64_t{1} << 28;
+
+struct step_grid
+{
+	bounding_box box;
+	int tiles_width;
+	std::vector<std::vector<int>> tiles;
+
+	explicit step_grid(const bounding_box& box) :
+		box{box},
+		tiles_width{((box.max_x - box.min_x) >> grid_tile_bits) + 1},
+		tiles(std::size_t(tiles_width) * std::size_t(((box.max_y - box.min_y) >> grid_tile_bits) + 1))
+	{}
+
+	auto get_tile_index(const int x, const int y) const -> std::size_t
+	{
+		return std::size_t((y - box.min_y) >> grid_tile_bits) * std::size_t(tiles_width) + std::size_t((x - box.min_x) >> grid_tile_bits);
+	}
+
+	auto get_cell_index(const int x, const int y) const -> std::size_t
+	{
+		return std::size_t(((y - box.min_y) & (grid_tile_size - 1)) << grid_tile_bits) + std::size_t((x - box.min_x) & (grid_tile_size - 1));
+	}
+
+	auto mark(const int x, const int y, const int segment) -> void
+	{
+		auto& tile = tiles[get_tile_index(x, y)];
+		if (tile.empty())
+			tile.resize(grid_tile_size * grid_tile_size, 0);
+
+		auto& cell = tile[get_cell_index(x, y)];
+		if (cell == 0 || segment + 1 < cell)
+			cell = segment + 1;
+	}
+
+	auto get_segment(const int x, const int y) const -> int
+	{
+		const auto& tile = tiles[get_tile_index(x, y)];
+		if (tile.empty())
+			return -1;
+		return tile[get_cell_index(x, y)] - 1;
+	}
+};
+
+auto get_overlapping_box(const bounding_box& box1, const bounding_box& box2) -> std::optional<bounding_box>
+{
+	const bounding_box box{std::max(box1.min_x, box2.min_x), std::min(box1.max_x, box2.max_x),
+						   std::max(box1.min_y, box2.min_y), std::min(box1.max_y, box2.max_y)};
+
+	if (box.min_x > box.max_x || box.min_y > box.max_y)
+		return std::nullopt;
+	return box;
+}
+
+auto get_box_cells(const bounding_box& box) -> std::int64_t
+{
+	return (std::int64_t{box.max_x} - box.min_x + 1) * (std::int64_t{box.max_y} - box.min_y + 1);
+}
+
+template<typename Function>
+auto for_each_cell_in_box(const axis_segments& segments, const bool horizontal, const bounding_box& box, Function function) -> void
+{
+	const auto min_fixed = horizontal ? box.min_y : box.min_x;
+	const auto max_fixed = horizontal ? box.max_y : box.max_x;
+	const auto min_pos = horizontal ? box.min_x : box.min_y;
+	const auto max_pos = horizontal ? box.max_x : box.max_y;
+
+	for (auto i = 0; i < segments.size(); ++i)
+	{
+		const auto fixed = segments.fixed[i];
+		if (fixed < min_fixed || fixed > max_fixed)
+			continue;
+
+		const auto end_pos = std::min(segments.hi[i], max_pos);
+		for (auto pos = std::max(segments.lo[i], min_pos); pos <= end_pos; ++pos)
+		{
+			if (horizontal)
+				function(pos, fixed, segments.index[i]);
+			else
+				function(fixed, pos, segments.index[i]);
+		}
+	}
+}
+
+auto get_grid_intersections(const wire_segments& wire1, const wire_segments& wire2, const bounding_box& box) -> std::vector<intersection>
+{
+	std::vector<intersection> intersections;
+
+	step_grid grid(box);
+
+	const auto mark_cell = [&grid] (const int x, const int y, const int segment) {
+		grid.mark(x, y, segment);
+	};
+	for_each_cell_in_box(wire1.horizontals, true, box, mark_cell);
+	for_each_cell_in_box(wire1.verticals, false, box, mark_cell);
+
+	const auto check_cell = [&grid, &intersections] (const int x, const int y, const int segment) {
+		const auto wire1_segment = grid.get_segment(x, y);
+		if (wire1_segment != -1)
+			intersections.push_back({{x, y}, wire1_segment, segment});
+	};
+	for_each_cell_in_box(wire2.horizontals, true, box, check_cell);
+	for_each_cell_in_box(wire2.verticals, false, box, check_cell);
+
+	remove_central_port(intersections);
 
 	return intersections;
 }
 
+auto use_grid_intersections(const wire_segments& wire1, const wire_segments& wire2, const bounding_box& box) -> bool
+{
+	const auto num_segments = std::int64_t(wire1.horizontals.size() + wire1.verticals.size() +
+											 wire2.horizontals.size() + wire2.verticals.size());
+	const auto max_cells = std::min(grid_max_cells, grid_max_cells_per_segment * num_segments);
+	const auto total_length = std::int64_t{wire1.length} + wire2.length;
+
+	return get_box_cells(box) <= max_cells && total_length <= max_cells;
+}
+
+auto get_intersections(const wire_segments& wire1, const wire_segments& wire2) -> std::vector<intersection>
+{
+	const auto box = get_overlapping_box(wire1.box, wire2.box);
+
+	if (!box)
+		return {};
+
+	if (use_grid_intersections(wire1, wire2, *box))
+		return get_grid_intersections(wire1, wire2, *box);
+
+	return get_sweep_intersections(wire1, wire2);
+}
+
 auto get_distance(const std::pair<int, int>& point) -> int
 {
 	return std::abs(point.first) + std::abs(point.second);
 }
 
-auto get_closest_intersection(const std::vector<std::pair<int, int>>& intersections) -> std::pair<int, int>
+auto get_closest_intersection(const std::vector<intersection>& intersections) -> std::pair<int, int>
 {
 	std::pair<int, int> closest{std::numeric_limits<int>::max()/2, std::numeric_limits<int>::max()/2};
 
-	std::for_each(++intersections.begin(), intersections.end(), 
-		[&closest] (const std::pair<int, int>& intersection) {
-			if (get_distance(intersection) < get_distance(closest))
-				closest = intersection;
+	std::for_each(intersections.begin(), intersections.end(), 
+		[&closest] (const intersection& intersection) {
+			if (get_distance(intersection.point) < get_distance(closest))
+				closest = intersection.point;
 		});
 	
 	return closest;
 }
 
-auto get_points_distance(const std::pair<int, int>& point1, const std::pair<int, int>& point2) -> int
+auto get_signal_delay(const wire_segments& wire, const int segment, const std::pair<int, int>& point) -> int
 {
-	return std::abs(point1.first - point2.first) + std::abs(point1.second - point2.second);
+	return wire.steps[segment] + get_points_distance(wire.starts[segment], point);
+}
+
+auto get_shortest_intersections_distance(const wire_segments& wire1, const wire_segments& wire2,
+										 const std::vector<intersection>& intersections) -> int
+{
+	auto shortest_distance = std::numeric_limits<int>::max();
+	
+	std::for_each(intersections.begin(), intersections.end(), [&] (const intersection& intersection) {
+
+		auto distance = get_signal_delay(wire1, intersection.wire1_segment, intersection.point);
+		distance += get_signal_delay(wire2, intersection.wire2_segment, intersection.point);
+		
+		if (distance < shortest_distance)
+			shortest_distance = distance;
+	});
+	
+	return shortest_distance;
+}
+
+struct tagged_wire
+{
+	std::string tag;
+	wire_segments segments;
+};
+
+struct wire_pair_result
+{
+	int wire1_index;
+	int wire2_index;
+	std::pair<int, int> closest_intersection;
+	int shortest_distance;
+};
+
+auto load_tagged_wires(std::ifstream& data_file) -> std::vector<tagged_wire>
+{
+	std::vector<tagged_wire> wires;
+
+	std::string line;
+	while (data_file >> line)
+	{
+		tagged_wire wire;
+
+		const auto separator_index = line.find(':');
+		if (separator_index != std::string::npos)
+		{
+			wire.tag = line.substr(0, separator_index);
+			line = line.substr(separator_index + 1);
+		}
+
+		wire.segments = get_wire_segments(get_wire_vector(line));
+		wires.push_back(std::move(wire));
+	}
+
+	return wires;
 }
 
-auto intersects_segment(const std::pair<int, int>& point1, const std::pair<int, int>& point2,
-						 const std::pair<int, int>& intersection) -> bool
+struct wire_group_segments
+{
+	axis_segments horizontals;
+	axis_segments verticals;
+	std::vector<int> segment_wires;
+	std::vector<int> segment_indices;
+};
+
+auto get_wire_groups(const std::vector<tagged_wire>& wires) -> std::vector<std::vector<int>>
 {
-	if (point1.first == point2.first && point1.first == intersection.first)
+	std::map<std::string, std::vector<int>> groups;
+	for (auto i = 0; i < int(wires.size()); ++i)
+		groups[wires[i].tag].push_back(i);
+
+	std::vector<std::vector<int>> wire_groups;
+	for (auto& group : groups)
 	{
-		const auto[second_min, second_max] = std::minmax(point1.second, point2.second);
-		return (second_min <= intersection.second && second_max >= intersection.second);
+		if (group.second.size() > 1)
+			wire_groups.push_back(std::move(group.second));
 	}
 
-	if (point1.second == point2.second && point1.second == intersection.second)
+	return wire_groups;
+}
+
+auto append_group_segments(const axis_segments& segments, const int wire_index, wire_group_segments& group, axis_segments& group_segments) -> void
+{
+	for (auto i = 0; i < segments.size(); ++i)
 	{
-		const auto[first_min, first_max] = std::minmax(point1.first, point2.first);
-		return (first_min <= intersection.first && first_max >= intersection.first);
+		group_segments.push_back(segments.fixed[i], segments.lo[i], segments.hi[i], int(group.segment_wires.size()));
+		group.segment_wires.push_back(wire_index);
+		group.segment_indices.push_back(segments.index[i]);
 	}
+}
+
+auto get_wire_group_segments(const std::vector<tagged_wire>& wires, const std::vector<int>& wire_indices) -> wire_group_segments
+{
+	wire_group_segments group;
+
+	for (const auto wire_index : wire_indices)
+	{
+		append_group_segments(wires[wire_index].segments.horizontals, wire_index, group, group.horizontals);
+		append_group_segments(wires[wire_index].segments.verticals, wire_index, group, group.verticals);
+	}
+
+	return group;
+}
+
+template<typename Function>
+auto for_each_group_overlapping_point(const axis_segments& segments, const std::vector<int>& segment_wires, const bool horizontal,
+									  Function function) -> void
+{
+	std::vector<int> order(segments.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&segments] (const int l, const int r) {
+		return std::tie(segments.fixed[l], segments.lo[l]) < std::tie(segments.fixed[r], segments.lo[r]);
+	});
+
+	std::multiset<std::pair<int, int>> active_segments;
+	auto current_fixed = std::numeric_limits<int>::min();
 
-	return false;
+	for (const auto i : order)
+	{
+		const auto fixed = segments.fixed[i];
+		const auto lo = segments.lo[i];
+		const auto hi = segments.hi[i];
+		const auto segment = segments.index[i];
+
+		if (fixed != current_fixed)
+		{
+			active_segments.clear();
+			current_fixed = fixed;
+		}
+
+		while (!active_segments.empty() && active_segments.begin()->first < lo)
+			active_segments.erase(active_segments.begin());
+
+		for (const auto&[other_hi, other_segment] : active_segments)
+		{
+			if (segment_wires[other_segment] == segment_wires[segment])
+				continue;
+
+			const auto end_pos = std::min(other_hi, hi);
+			for (auto pos = lo; pos <= end_pos; ++pos)
+				function(horizontal ? std::pair<int, int>{pos, fixed} : std::pair<int, int>{fixed, pos}, other_segment, segment);
+		}
+
+		active_segments.emplace(hi, segment);
+	}
 }
 
-auto get_shortest_intersection_distance (const std::vector<std::pair<int, int>>& wire, const std::pair<int, int>& intersection) -> int
+auto get_fixed_ranges(const axis_segments& segments, const int num_chunks) -> std::vector<std::pair<int, int>>
 {
-	auto distance = 0;
-	auto first_elem = true;
-	auto start_point = wire.front();
+	auto fixed = segments.fixed;
+	std::sort(fixed.begin(), fixed.end());
+
+	std::vector<std::pair<int, int>> ranges;
+	auto lo = std::numeric_limits<int>::min();
 
-	for (const auto& end_point : wire) 
+	for (auto chunk = 1; chunk < num_chunks; ++chunk)
 	{
-		if (first_elem)
+		const auto boundary = fixed[fixed.size() * std::size_t(chunk) / std::size_t(num_chunks)];
+		if (boundary > lo)
 		{
-			first_elem = false;
+			ranges.emplace_back(lo, boundary - 1);
+			lo = boundary;
+		}
+	}
+
+	ranges.emplace_back(lo, std::numeric_limits<int>::max());
+
+	return ranges;
+}
+
+struct pair_best
+{
+	std::pair<int, int> closest;
+	int closest_distance;
+	int shortest_distance;
+};
+
+using pair_best_map = std::unordered_map<std::uint64_t, pair_best>;
+
+auto get_pair_key(const int wire1, const int wire2) -> std::uint64_t
+{
+	return (std::uint64_t(std::uint32_t(wire1)) << 32) | std::uint32_t(wire2);
+}
+
+auto update_pair_best(pair_best& best, const std::pair<int, int>& point, const int distance, const int shortest_distance) -> void
+{
+	if (std::tie(distance, point) < std::tie(best.closest_distance, best.closest))
+	{
+		best.closest = point;
+		best.closest_distance = distance;
+	}
+
+	best.shortest_distance = std::min(best.shortest_distance, shortest_distance);
+}
+
+auto add_group_intersection(const std::vector<tagged_wire>& wires, const wire_group_segments& group, const std::pair<int, int>& point,
+							const int segment1, const int segment2, pair_best_map& pairs) -> void
+{
+	const auto wire1 = group.segment_wires[segment1];
+	const auto wire2 = group.segment_wires[segment2];
+
+	if (wire1 == wire2 || point == std::pair<int, int>{0, 0})
+		return;
+
+	const auto shortest_distance = get_signal_delay(wires[wire1].segments, group.segment_indices[segment1], point) +
+								   get_signal_delay(wires[wire2].segments, group.segment_indices[segment2], point);
+	const auto distance = get_distance(point);
+
+	const auto[it, inserted] = pairs.try_emplace(get_pair_key(std::min(wire1, wire2), std::max(wire1, wire2)),
+												 pair_best{point, distance, shortest_distance});
+	if (!inserted)
+		update_pair_best(it->second, point, distance, shortest_distance);
+}
+
+auto get_group_pair_bests(const std::vector<tagged_wire>& wires, const wire_group_segments& group) -> pair_best_map
+{
+	constexpr auto chunks_per_thread = 4;
+	constexpr auto segments_per_chunk = 1024;
+	constexpr auto min_fixed = std::numeric_limits<int>::min();
+	constexpr auto max_fixed = std::numeric_limits<int>::max();
+
+	const auto num_threads = int(std::max(1u, std::thread::hardware_concurrency()));
+	const auto num_segments = group.horizontals.size() + group.verticals.size();
+	const auto num_chunks = std::max(1, std::max(num_threads * chunks_per_thread, num_segments / segments_per_chunk));
+
+	// Crossings are split into strips of vertical x and overlaps into ranges
+	// of the fixed coordinate, so every point is found by exactly one task
+	// and each task only keeps the best points of the pairs it meets.
+	std::vector<std::function<void(pair_best_map&)>> tasks;
+
+	if (group.horizontals.size() != 0 && group.verticals.size() != 0)
+	{
+		for (const auto& range : get_fixed_ranges(group.verticals, num_chunks))
+		{
+			tasks.emplace_back([&wires, &group, lo = range.first, hi = range.second] (pair_best_map& pairs) {
+				for_each_crossing_point(get_segments_in_range(group.horizontals, min_fixed, max_fixed, lo, hi),
+										get_segments_in_range(group.verticals, lo, hi, min_fixed, max_fixed),
+										[&] (const std::pair<int, int>& point, const int segment1, const int segment2) {
+					add_group_intersection(wires, group, point, segment1, segment2, pairs);
+				});
+			});
+		}
+	}
+
+	for (const auto horizontal : {true, false})
+	{
+		const auto& segments = horizontal ? group.horizontals : group.verticals;
+		if (segments.size() < 2)
 			continue;
+
+		for (const auto& range : get_fixed_ranges(segments, num_chunks))
+		{
+			tasks.emplace_back([&wires, &group, &segments, horizontal, lo = range.first, hi = range.second] (pair_best_map& pairs) {
+				for_each_group_overlapping_point(get_segments_in_range(segments, lo, hi, min_fixed, max_fixed), group.segment_wires, horizontal,
+												 [&] (const std::pair<int, int>& point, const int segment1, const int segment2) {
+					add_group_intersection(wires, group, point, segment1, segment2, pairs);
+				});
+			});
 		}
-		
-		if (intersects_segment(start_point, end_point, intersection))
-			return distance + get_points_distance(start_point, intersection);
-			
-		distance += get_points_distance(start_point, end_point);
-		start_point = end_point;
 	}
 
-	return distance;
+	pair_best_map group_pairs;
+	std::mutex group_pairs_mutex;
+
+	std::atomic<std::size_t> next_task{0};
+	const auto worker = [&] {
+		for (auto i = next_task++; i < tasks.size(); i = next_task++)
+		{
+			pair_best_map task_pairs;
+			tasks[i](task_pairs);
+
+			const std::lock_guard<std::mutex> lock(group_pairs_mutex);
+			for (const auto&[key, best] : task_pairs)
+			{
+				const auto[it, inserted] = group_pairs.try_emplace(key, best);
+				if (!inserted)
+					update_pair_best(it->second, best.closest, best.closest_distance, best.shortest_distance);
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (auto i = 1; i < std::min(num_threads, int(tasks.size())); ++i)
+		threads.emplace_back(worker);
+
+	worker();
+
+	for (auto& thread : threads)
+		thread.join();
+
+	return group_pairs;
 }
 
-auto get_shortest_intersections_distance(const std::vector<std::pair<int, int>>& wire1, const std::vector<std::pair<int, int>>& wire2,
-										 const std::vector<std::pair<int, int>>& intersections) -> int
+auto get_all_pairs_results(const std::vector<tagged_wire>& wires) -> std::vector<wire_pair_result>
 {
-	auto shortest_distance = std::numeric_limits<int>::max();
-	
-	std::for_each(++intersections.begin(), intersections.end(), [&] (const std::pair<int, int>& intersection) {
+	std::vector<wire_pair_result> results;
 
-		auto distance = get_shortest_intersection_distance (wire1, intersection);
-		distance += get_shortest_intersection_distance (wire2, intersection);
-		
-		if (distance < shortest_distance)
-			shortest_distance = distance;
+	for (const auto& wire_indices : get_wire_groups(wires))
+	{
+		for (const auto&[key, best] : get_group_pair_bests(wires, get_wire_group_segments(wires, wire_indices)))
+			results.push_back({int(key >> 32), int(key & 0xffffffff), best.closest, best.shortest_distance});
+	}
+
+	std::sort(results.begin(), results.end(), [] (const wire_pair_result& l, const wire_pair_result& r) {
+		return std::tie(l.wire1_index, l.wire2_index) < std::tie(r.wire1_index, r.wire2_index);
 	});
-	
-	return shortest_distance;
+
+	return results;
+}
+
+auto print_all_pairs_results(const std::vector<tagged_wire>& wires) -> void
+{
+	for (const auto& result : get_all_pairs_results(wires))
+	{
+		std::cout << "Wires " << (result.wire1_index + 1) << " and " << (result.wire2_index + 1) << ": ";
+
+		const auto& closest = result.closest_intersection;
+		std::cout << "closest intersection (" << closest.first << ", " << closest.second << "), "
+				  << "Manhattan distance: " << get_distance(closest) << ", "
+				  << "shortest distance: " << result.shortest_distance << std::endl;
+	}
 }
 
+auto solve(const std::string_view input) -> solution
+{
+	solution result;
+
+	const auto[wire1, wire2] = time_phase(result.parse_time, [&] {
+		auto data = input;
+		const auto wire1_raw = next_token(data);
+		const auto wire2_raw = next_token(data);
+		return std::make_pair(get_wire_segments(get_wire_vector(wire1_raw)), get_wire_segments(get_wire_vector(wire2_raw)));
+	});
+
+	std::vector<intersection> intersections;
+
+	result.part1 = time_phase(result.part1_time, [&] {
+		intersections = get_intersections(wire1, wire2);
+		if (intersections.empty())
+			return std::string();
+		return std::to_string(get_distance(get_closest_intersection(intersections)));
+	});
+
+	if (intersections.empty())
+		return result;
+
+	result.part2 = time_phase(result.part2_time, [&] {
+		return std::to_string(get_shortest_intersections_distance(wire1, wire2, intersections));
+	});
+
+	return result;
+}
+
+} // namespace day3
+
+#ifndef AOC_RUNNER
+using namespace day3;
+
 int main(int argc, char* argv[])
 {
-	if (argc != 2)
+	const auto all_pairs = (argc == 3 && std::string(argv[2]) == "--all-pairs");
+
+	if (argc != 2 && !all_pairs)
 	{
 		std::cerr << "Error! An input file is required!" << std::endl;
 		return -1;
@@ -231,13 +892,19 @@ int main(int argc, char* argv[])
 		return -1;
 	}
 
+	if (all_pairs)
+	{
+		print_all_pairs_results(load_tagged_wires(data_file));
+		return 0;
+	}
+
 	std::string wire1_raw;
 	data_file >> wire1_raw;
-	const auto wire1 = get_wire_vector(wire1_raw);
+	const auto wire1 = get_wire_segments(get_wire_vector(wire1_raw));
 	
 	std::string wire2_raw;
 	data_file >> wire2_raw;
-	const auto wire2 = get_wire_vector(wire2_raw);
+	const auto wire2 = get_wire_segments(get_wire_vector(wire2_raw));
 
 	const auto intersections = get_intersections(wire1, wire2);
 
@@ -252,3 +919,4 @@ int main(int argc, char* argv[])
 
 	return 0;
 }
+#endif
@@ -1,84 +1,445 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <optional>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
-auto is_valid_password_part1(const std::string& password) -> bool
+#include "../common/parse.hpp"
+#include "../common/solution.hpp"
+
+namespace day4
 {
-	auto last_char = '0';
-	auto adjacent = false;
-	
-	for (const auto new_char : password)
+
+struct password_state
+{
+	bool ordered;
+	std::uint64_t last_digit;
+	int trailing_adjacent_num;
+	bool adjacent;
+	bool exact_adjacent;
+};
+
+auto get_password_state(std::uint64_t password) -> password_state
+{
+	password_state state{true, password % 10, 0, false, false};
+
+	auto last_digit = state.last_digit;
+	auto adjacent_num = 1;
+
+	const auto end_run = [&state, &adjacent_num] {
+		if (state.trailing_adjacent_num == 0)
+			state.trailing_adjacent_num = adjacent_num;
+		else
+		{
+			state.adjacent = state.adjacent || adjacent_num >= 2;
+			state.exact_adjacent = state.exact_adjacent || adjacent_num == 2;
+		}
+		adjacent_num = 1;
+	};
+
+	for (password /= 10; password != 0; password /= 10)
 	{
-		if (new_char < last_char)
-			return false;
+		const auto digit = password % 10;
 
-		if (last_char == new_char)
-			adjacent = true;
+		if (digit > last_digit)
+		{
+			state.ordered = false;
+			return state;
+		}
+
+		if (digit == last_digit)
+			adjacent_num++;
+		else
+			end_run();
 
-		last_char = new_char;
+		last_digit = digit;
 	}
 
-	return adjacent;
+	end_run();
+
+	return state;
 }
 
-auto is_valid_password_part2(const std::string& password) -> bool
+auto count_valid_passwords_in_decade(const std::uint64_t prefix, const std::uint64_t first_digit, const std::uint64_t last_digit,
+									 std::uint64_t& part1, std::uint64_t& part2) -> void
 {
-	auto last_char = '0';
-	auto adjacent = false;
-	auto adjacent_num = 1;
+	if (prefix == 0)
+		return;
+
+	const auto state = get_password_state(prefix);
+
+	if (!state.ordered)
+		return;
 
-	for (const auto new_char : password)
+	const std::uint32_t adjacent = state.adjacent || state.trailing_adjacent_num >= 2;
+	const std::uint32_t exact_adjacent = state.exact_adjacent || state.trailing_adjacent_num == 2;
+	const std::uint32_t exact_adjacent_if_same = state.exact_adjacent || state.trailing_adjacent_num == 1;
+
+	for (auto digit = first_digit; digit <= last_digit; ++digit)
 	{
-		if (new_char < last_char)
-			return false;
+		const std::uint32_t ordered = digit >= state.last_digit;
+		const std::uint32_t same = digit == state.last_digit;
 
-		if (new_char == last_char)
-			adjacent_num++;
-		else
+		part1 += ordered & (adjacent | same);
+		part2 += ordered & (same ? exact_adjacent_if_same : exact_adjacent);
+	}
+}
+
+auto count_valid_passwords_by_enumeration(const std::uint64_t start, const std::uint64_t end) -> std::pair<std::uint64_t, std::uint64_t>
+{
+	auto part1 = std::uint64_t{0};
+	auto part2 = std::uint64_t{0};
+
+	if (start > end)
+		return {part1, part2};
+
+	const auto end_prefix = end / 10;
+
+	for (auto prefix = start / 10, first_digit = start % 10;; ++prefix, first_digit = 0)
+	{
+		const auto last_digit = prefix == end_prefix ? end % 10 : 9;
+		count_valid_passwords_in_decade(prefix, first_digit, last_digit, part1, part2);
+
+		if (prefix == end_prefix)
+			break;
+	}
+
+	return {part1, part2};
+}
+
+enum class password_rule
+{
+	part1,
+	part2
+};
+
+constexpr auto max_password_digits = 20;
+constexpr auto max_tracked_run = 3;
+
+class password_counter
+{
+public:
+	explicit password_counter(const std::uint64_t limit, const password_rule rule) :
+		rule{rule}
+	{
+		for (const auto digit : std::to_string(limit))
+			digits.push_back(digit - '0');
+
+		for (auto& pos_memo : memo)
+			for (auto& last_memo : pos_memo)
+				for (auto& run_memo : last_memo)
+					run_memo.fill(not_computed);
+	}
+
+	auto count() -> std::uint64_t
+	{
+		return count_from(0, 0, 0, false, true, false);
+	}
+
+private:
+	static constexpr auto not_computed = std::numeric_limits<std::uint64_t>::max();
+
+	auto count_from(const int pos, const int last_digit, const int run, const bool valid,
+					const bool tight, const bool started) -> std::uint64_t
+	{
+		if (pos == int(digits.size()))
+			return (started && (valid || (rule == password_rule::part2 && run == 2))) ? 1 : 0;
+
+		const auto memoize = !tight && started;
+		if (memoize && memo[pos][last_digit][run][valid] != not_computed)
+			return memo[pos][last_digit][run][valid];
+
+		const auto max_digit = tight ? digits[pos] : 9;
+		auto total = std::uint64_t{0};
+
+		for (auto digit = started ? last_digit : 0; digit <= max_digit; ++digit)
 		{
-			if (adjacent_num == 2)
-				adjacent = true;
-			adjacent_num = 1;
+			const auto next_tight = tight && digit == max_digit;
+
+			if (!started)
+			{
+				total += digit == 0 ? count_from(pos + 1, 0, 0, false, next_tight, false)
+									: count_from(pos + 1, digit, 1, false, next_tight, true);
+			}
+			else if (digit == last_digit)
+			{
+				const auto next_run = std::min(run + 1, max_tracked_run);
+				const auto next_valid = valid || (rule == password_rule::part1 && next_run >= 2);
+				total += count_from(pos + 1, digit, next_run, next_valid, next_tight, true);
+			}
+			else
+			{
+				const auto next_valid = valid || (rule == password_rule::part2 && run == 2);
+				total += count_from(pos + 1, digit, 1, next_valid, next_tight, true);
+			}
 		}
 
-		last_char = new_char;
+		if (memoize)
+			memo[pos][last_digit][run][valid] = total;
+
+		return total;
 	}
 
-	if (adjacent_num == 2)
-		return true;
-	
-	return adjacent;
+	password_rule rule;
+	std::vector<int> digits;
+	std::array<std::array<std::array<std::array<std::uint64_t, 2>, max_tracked_run + 1>, 10>, max_password_digits> memo;
+};
+
+auto count_valid_passwords_up_to(const std::uint64_t limit, const password_rule rule) -> std::uint64_t
+{
+	return password_counter(limit, rule).count();
 }
 
+auto count_valid_passwords(const std::uint64_t start, const std::uint64_t end, const password_rule rule) -> std::uint64_t
+{
+	if (start > end)
+		return 0;
+
+	const auto below_start = start == 0 ? 0 : count_valid_passwords_up_to(start - 1, rule);
+	return count_valid_passwords_up_to(end, rule) - below_start;
+}
+
+struct password_digits
+{
+	std::array<std::uint8_t, max_password_digits> digits;
+	int size;
+};
+
+auto get_password_digits(std::uint64_t password) -> password_digits
+{
+	password_digits result{};
+
+	do
+	{
+		result.digits[result.size++] = std::uint8_t(password % 10);
+		password /= 10;
+	} while (password != 0);
+
+	std::reverse(result.digits.begin(), result.digits.begin() + result.size);
+
+	return result;
+}
+
+using password_check = std::function<bool(const password_digits&)>;
+using password_rule_set = std::vector<password_check>;
+
+auto get_digits_never_decrease_check() -> password_check
+{
+	return [] (const password_digits& password) {
+		return std::is_sorted(password.digits.begin(), password.digits.begin() + password.size);
+	};
+}
+
+auto get_adjacent_digits_check(const int min_adjacent_num, const int max_adjacent_num) -> password_check
+{
+	return [min_adjacent_num, max_adjacent_num] (const password_digits& password) {
+		auto adjacent_num = 1;
+		for (auto i = 1; i <= password.size; ++i)
+		{
+			if (i < password.size && password.digits[i] == password.digits[i - 1])
+				adjacent_num++;
+			else
+			{
+				if (adjacent_num >= min_adjacent_num && adjacent_num <= max_adjacent_num)
+					return true;
+				adjacent_num = 1;
+			}
+		}
+		return false;
+	};
+}
+
+auto get_num_digits_check(const int num_digits) -> password_check
+{
+	return [num_digits] (const password_digits& password) {
+		return password.size == num_digits;
+	};
+}
+
+auto get_password_check(const std::string& name) -> std::optional<password_check>
+{
+	if (name == "never_decrease")
+		return get_digits_never_decrease_check();
+	if (name == "adjacent")
+		return get_adjacent_digits_check(2, max_password_digits);
+	if (name == "exact_pair")
+		return get_adjacent_digits_check(2, 2);
+	if (name == "six_digits")
+		return get_num_digits_check(6);
+	return std::nullopt;
+}
+
+auto get_password_rule_set(const std::string& rule_set_raw) -> std::optional<password_rule_set>
+{
+	password_rule_set rule_set;
+
+	std::stringstream ss_rule_set_raw(rule_set_raw);
+	std::string name;
+
+	while (std::getline(ss_rule_set_raw, name, '+'))
+	{
+		auto check = get_password_check(name);
+		if (!check)
+			return std::nullopt;
+		rule_set.push_back(std::move(*check));
+	}
+
+	return rule_set;
+}
+
+auto count_rule_sets_passwords(const std::uint64_t start, const std::uint64_t end, const std::vector<password_rule_set>& rule_sets,
+							   std::vector<std::uint64_t>& counts) -> void
+{
+	for (auto password = start;; ++password)
+	{
+		const auto digits = get_password_digits(password);
+
+		for (auto i = std::size_t{0}; i < rule_sets.size(); ++i)
+		{
+			const auto& rule_set = rule_sets[i];
+			if (std::all_of(rule_set.begin(), rule_set.end(), [&digits] (const password_check& check) { return check(digits); }))
+				counts[i]++;
+		}
+
+		if (password == end)
+			break;
+	}
+}
+
+template<typename ChunkCounter>
+auto count_passwords_in_parallel(const std::uint64_t start, const std::uint64_t end, const std::size_t num_counters,
+								 ChunkCounter count_chunk) -> std::vector<std::uint64_t>
+{
+	std::vector<std::uint64_t> counts(num_counters, 0);
+
+	if (start > end)
+		return counts;
+
+	const auto num_threads = std::uint64_t{std::max(1u, std::thread::hardware_concurrency())};
+	const auto chunk_size = (end - start) / num_threads + 1;
+
+	const auto num_chunks = std::size_t((end - start) / chunk_size + 1);
+
+	std::vector<std::vector<std::uint64_t>> thread_counts(num_chunks, std::vector<std::uint64_t>(num_counters, 0));
+	std::vector<std::thread> threads;
+
+	for (auto chunk = std::size_t{0}; chunk < num_chunks; ++chunk)
+	{
+		const auto chunk_start = start + chunk * chunk_size;
+		const auto chunk_end = chunk_start + std::min(chunk_size - 1, end - chunk_start);
+
+		threads.emplace_back([&count_chunk, &thread_counts, chunk, chunk_start, chunk_end] {
+			count_chunk(chunk_start, chunk_end, thread_counts[chunk]);
+		});
+	}
+
+	for (auto& thread : threads)
+		thread.join();
+
+	for (const auto& chunk_counts : thread_counts)
+	{
+		for (auto i = std::size_t{0}; i < num_counters; ++i)
+			counts[i] += chunk_counts[i];
+	}
+
+	return counts;
+}
+
+auto solve(const std::string_view input) -> solution
+{
+	solution result;
+
+	const auto[start, end] = time_phase(result.parse_time, [&] {
+		auto data = input;
+		const auto range = next_token(data);
+		const auto separator_index = std::min(range.find('-'), range.size());
+
+		std::uint64_t range_start = 0;
+		std::uint64_t range_end = 0;
+		parse_integer(range.substr(0, separator_index), range_start);
+		parse_integer(range.substr(std::min(separator_index + 1, range.size())), range_end);
+		return std::make_pair(range_start, range_end);
+	});
+
+	result.part1 = time_phase(result.part1_time, [&] {
+		return std::to_string(count_valid_passwords(start, end, password_rule::part1));
+	});
+
+	result.part2 = time_phase(result.part2_time, [&] {
+		return std::to_string(count_valid_passwords(start, end, password_rule::part2));
+	});
+
+	return result;
+}
+
+} // namespace day4
+
+#ifndef AOC_RUNNER
+using namespace day4;
+
 int main(int argc, char* argv[])
 {
-	if (argc != 3)
+	const auto enumerate = (argc == 4 && std::string(argv[3]) == "--enumerate");
+	const auto rules = (argc >= 5 && std::string(argv[3]) == "--rules");
+
+	if (argc != 3 && !enumerate && !rules)
 	{
 		std::cerr << "Error! Two ints are required!" << std::endl;
 		return -1;
 	}
 
-	const auto start = atoi(argv[1]);
-	const auto end = atoi(argv[2]);
+	const auto start = std::strtoull(argv[1], nullptr, 10);
+	const auto end = std::strtoull(argv[2], nullptr, 10);
 
 	std::cout << "Passwords from " << start << " to " << end << std::endl;
 
-	auto num_passwords = 0;
-	for (auto password = start; password <= end; ++password)
+	if (enumerate)
 	{
-		if (is_valid_password_part1(std::to_string(password)))
-			num_passwords++;
+		const auto counts = count_passwords_in_parallel(start, end, 2, [] (const std::uint64_t chunk_start, const std::uint64_t chunk_end,
+																		   std::vector<std::uint64_t>& chunk_counts) {
+			const auto[part1, part2] = count_valid_passwords_by_enumeration(chunk_start, chunk_end);
+			chunk_counts[0] += part1;
+			chunk_counts[1] += part2;
+		});
+		std::cout << "Part 1: " << counts[0] << " passwords found." << std::endl;
+		std::cout << "Part 2: " << counts[1] << " passwords found." << std::endl;
+		return 0;
 	}
 
-	std::cout << "Part 1: " << num_passwords << " passwords found." << std::endl;
-
-	num_passwords = 0;
-	for (auto password = start; password <= end; ++password)
+	if (rules)
 	{
-		if (is_valid_password_part2(std::to_string(password)))
-			num_passwords++;
+		std::vector<password_rule_set> rule_sets;
+		for (auto i = 4; i < argc; ++i)
+		{
+			auto rule_set = get_password_rule_set(argv[i]);
+			if (!rule_set)
+			{
+				std::cerr << "Error! Unknown rule in rule set: " << argv[i] << std::endl;
+				return -1;
+			}
+			rule_sets.push_back(std::move(*rule_set));
+		}
+
+		const auto counts = count_passwords_in_parallel(start, end, rule_sets.size(), [&rule_sets] (const std::uint64_t chunk_start, const std::uint64_t chunk_end,
+																									std::vector<std::uint64_t>& chunk_counts) {
+			count_rule_sets_passwords(chunk_start, chunk_end, rule_sets, chunk_counts);
+		});
+		for (auto i = 4; i < argc; ++i)
+			std::cout << argv[i] << ": " << counts[i - 4] << " passwords found." << std::endl;
+		return 0;
 	}
 
-	std::cout << "Part 2: " << num_passwords << " passwords found." << std::endl;
+	std::cout << "Part 1: " << count_valid_passwords(start, end, password_rule::part1) << " passwords found." << std::endl;
+	std::cout << "Part 2: " << count_valid_passwords(start, end, password_rule::part2) << " passwords found." << std::endl;
 	
 	return 0;
 }
+#endif
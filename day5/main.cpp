@@ -1,19 +1,19 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <string>
+#include <string_view>
 #include <vector>
 
-auto load_program(const std::string& data) -> std::vector<int>
+#include "../common/parse.hpp"
+#include "../common/solution.hpp"
+
+namespace day5
 {
-	std::vector<int> program;
 
-	std::stringstream ss_data(data);
-	std::string int_data;
-	
-	while (std::getline(ss_data, int_data, ',')) 
-		program.push_back(std::stoi(int_data));
-	
-	return program;
+auto load_program(const std::string_view data) -> std::vector<int>
+{
+	return parse_integer_list<int>(data, ',');
 }
 
 constexpr auto immediate_1st_param(int value) -> int
@@ -42,19 +42,19 @@ auto mul(std::vector<int>& memory, int& pc) -> void
 	pc += 4;
 }
 
-auto in(std::vector<int>& memory, int& pc) -> void
+auto in(std::vector<int>& memory, int& pc, std::istream& input, std::ostream& output) -> void
 {
 	int input_value;
-	std::cout << ">";
-	std::cin >> input_value;
+	output << ">";
+	input >> input_value;
 	memory[memory[pc + 1]] = input_value;
 	pc += 2;
 }
 
-auto out(std::vector<int>& memory, int& pc) -> void
+auto out(std::vector<int>& memory, int& pc, std::ostream& output) -> void
 {
 	const auto first_param  = (immediate_1st_param(memory[pc])) ? memory[pc + 1] : memory[memory[pc + 1]];
-	std::cout << first_param << std::endl;
+	output << first_param << std::endl;
 	pc += 2;
 }
 
@@ -94,7 +94,7 @@ auto eq(std::vector<int>& memory, int& pc) -> void
 	pc += 4;
 }
 
-auto run_program(std::vector<int>& memory) -> void
+auto run_program(std::vector<int>& memory, std::istream& input, std::ostream& output) -> void
 {
 	auto pc = 0;
 	auto end = false;
@@ -113,11 +113,11 @@ auto run_program(std::vector<int>& memory) -> void
 				break;
 
 			case 3:
-				in(memory, pc);
+				in(memory, pc, input, output);
 				break;
 
 			case 4:
-				out(memory, pc);
+				out(memory, pc, output);
 				break;
 
 			case 5:
@@ -148,6 +148,50 @@ auto run_program(std::vector<int>& memory) -> void
 	}
 }
 
+auto get_diagnostic_code(std::vector<int> memory, const int system_id) -> std::string
+{
+	std::istringstream input(std::to_string(system_id));
+	std::ostringstream output;
+
+	run_program(memory, input, output);
+
+	std::istringstream outputs(output.str());
+	std::string line;
+	std::string diagnostic_code;
+
+	while (std::getline(outputs, line))
+	{
+		line.erase(0, line.find_first_not_of('>'));
+		if (!line.empty())
+			diagnostic_code = line;
+	}
+
+	return diagnostic_code;
+}
+
+auto solve(const std::string_view input) -> solution
+{
+	solution result;
+
+	const auto memory = time_phase(result.parse_time, [&] {
+		auto data = input;
+		return load_program(next_token(data));
+	});
+
+	if (memory.empty())
+		return result;
+
+	result.part1 = time_phase(result.part1_time, [&] { return get_diagnostic_code(memory, 1); });
+	result.part2 = time_phase(result.part2_time, [&] { return get_diagnostic_code(memory, 5); });
+
+	return result;
+}
+
+} // namespace day5
+
+#ifndef AOC_RUNNER
+using namespace day5;
+
 int main(int argc, char* argv[])
 {
 	if (argc < 2)
@@ -169,7 +213,8 @@ int main(int argc, char* argv[])
 	
 	auto memory = load_program(data_program);
 
-	run_program(memory);
+	run_program(memory, std::cin, std::cout);
 	
 	return 0;
 }
+#endif
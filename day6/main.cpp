@@ -1,103 +1,552 @@
+#include <algorithm>
+#include <cstdint>
+#include <deque>
 #include <iostream>
 #include <fstream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
-using orbit_tree = std::unordered_map<std::string, std::vector<std::string>>;
+#include "../common/mapped_file.hpp"
+#include "../common/parse.hpp"
+#include "../common/solution.hpp"
 
-auto get_total_orbits(const orbit_tree& tree, const std::string& top, int depth, int& orbits) -> void
+namespace day6
 {
-	orbits += depth;
-	
-	if (tree.count(top) == 0)
-		return;
 
-	const auto& childs = tree.at(top);
+struct orbit_tree
+{
+	std::unique_ptr<mapped_file> file;
+	std::vector<std::string_view> names;
+	std::unordered_map<std::string_view, int> ids;
+	std::vector<int> parents;
+	std::vector<int> child_offsets;
+	std::vector<int> childs;
+};
+
+auto get_body_id(orbit_tree& tree, const std::string_view name) -> int
+{
+	const auto[it, inserted] = tree.ids.emplace(name, int(tree.names.size()));
+
+	if (inserted)
+	{
+		tree.names.push_back(name);
+		tree.parents.push_back(-1);
+	}
 
-	for (const auto& child : childs)
-		get_total_orbits(tree, child, depth + 1, orbits);
+	return it->second;
 }
 
-auto get_shortest_distance(const orbit_tree& tree, const std::string& top, int depth,
-							const std::string& node1, const std::string& node2,
-							int& distance) -> std::pair<int, int>
+auto find_body_id(const orbit_tree& tree, const std::string_view name) -> int
 {
-	std::pair<int, int> result{-1, -1};
-	
-	if (top == node1)
-		result.first = depth;
+	const auto it = tree.ids.find(name);
+	return it == tree.ids.end() ? -1 : it->second;
+}
+
+auto build_childs(orbit_tree& tree) -> void
+{
+	const auto num_bodies = int(tree.names.size());
 
-	if (top == node2)
-		result.second = depth;
+	tree.child_offsets.assign(num_bodies + 1, 0);
+	for (const auto parent : tree.parents)
+	{
+		if (parent != -1)
+			tree.child_offsets[parent + 1]++;
+	}
 
-	if (tree.count(top) == 0)
-		return result;
+	for (auto i = 0; i < num_bodies; ++i)
+		tree.child_offsets[i + 1] += tree.child_offsets[i];
 
-	const auto& childs = tree.at(top);
+	auto next_child = std::vector<int>(tree.child_offsets.begin(), tree.child_offsets.end() - 1);
+	tree.childs.resize(tree.child_offsets.back());
 
-	for (const auto& child : childs)
+	for (auto body = 0; body < num_bodies; ++body)
 	{
-		auto child_result = get_shortest_distance(tree, child, depth + 1, node1, node2, distance);
+		const auto parent = tree.parents[body];
+		if (parent != -1)
+			tree.childs[next_child[parent]++] = body;
+	}
+}
 
-		if (distance != -1)
-			return child_result;
+auto get_depths(const orbit_tree& tree) -> std::vector<int>
+{
+	const auto num_bodies = int(tree.names.size());
 
-		if (child_result.first != -1)
-			result.first = child_result.first;
+	std::vector<int> depths(num_bodies, -1);
+	std::vector<int> pending;
+	pending.reserve(num_bodies);
 
-		if (child_result.second != -1)
-			result.second = child_result.second;
+	for (auto body = 0; body < num_bodies; ++body)
+	{
+		if (tree.parents[body] == -1)
+		{
+			depths[body] = 0;
+			pending.push_back(body);
+		}
+	}
 
-		if (result.first != -1 && result.second != -1)
+	for (auto next = std::size_t{0}; next < pending.size(); ++next)
+	{
+		const auto body = pending[next];
+
+		for (auto i = tree.child_offsets[body]; i < tree.child_offsets[body + 1]; ++i)
 		{
-			distance = (result.first - depth) + (result.second - depth) - 2;
-			return result;
+			const auto child = tree.childs[i];
+			depths[child] = depths[body] + 1;
+			pending.push_back(child);
 		}
 	}
 
-	return result;
+	return depths;
+}
+
+auto get_total_orbits(const std::vector<int>& depths) -> std::int64_t
+{
+	auto orbits = std::int64_t{0};
+
+	for (const auto depth : depths)
+	{
+		if (depth > 0)
+			orbits += depth;
+	}
+
+	return orbits;
+}
+
+struct lca_index
+{
+	std::vector<int> depths;
+	std::vector<std::vector<int>> ancestors;
+};
+
+auto build_lca_index(const orbit_tree& tree, std::vector<int> depths) -> lca_index
+{
+	lca_index index{std::move(depths), {}};
+
+	const auto num_bodies = int(tree.names.size());
+	const auto max_depth = num_bodies == 0 ? 0 : *std::max_element(index.depths.begin(), index.depths.end());
+
+	auto& first_ancestors = index.ancestors.emplace_back(num_bodies);
+	for (auto body = 0; body < num_bodies; ++body)
+		first_ancestors[body] = tree.parents[body] == -1 ? body : tree.parents[body];
+
+	for (auto jump = 2; jump <= max_depth; jump *= 2)
+	{
+		const auto& previous = index.ancestors.back();
+		std::vector<int> next(num_bodies);
+
+		for (auto body = 0; body < num_bodies; ++body)
+			next[body] = previous[previous[body]];
+
+		index.ancestors.push_back(std::move(next));
+	}
+
+	return index;
+}
+
+auto get_ancestor(const lca_index& index, int node, int distance) -> int
+{
+	for (auto level = 0; distance != 0; ++level, distance >>= 1)
+	{
+		if (distance & 1)
+			node = index.ancestors[level][node];
+	}
+
+	return node;
+}
+
+auto get_lowest_common_ancestor(const lca_index& index, int node1, int node2) -> int
+{
+	if (index.depths[node1] > index.depths[node2])
+		node1 = get_ancestor(index, node1, index.depths[node1] - index.depths[node2]);
+	else
+		node2 = get_ancestor(index, node2, index.depths[node2] - index.depths[node1]);
+
+	if (node1 == node2)
+		return node1;
+
+	for (auto level = int(index.ancestors.size()) - 1; level >= 0; --level)
+	{
+		if (index.ancestors[level][node1] != index.ancestors[level][node2])
+		{
+			node1 = index.ancestors[level][node1];
+			node2 = index.ancestors[level][node2];
+		}
+	}
+
+	node1 = index.ancestors[0][node1];
+	node2 = index.ancestors[0][node2];
+
+	return node1 == node2 ? node1 : -1;
+}
+
+auto get_shortest_distance(const orbit_tree& tree, const lca_index& index, const int node1, const int node2) -> int
+{
+	if (node1 == -1 || node2 == -1 || index.depths[node1] == -1 || index.depths[node2] == -1)
+		return -1;
+
+	const auto orbited1 = tree.parents[node1];
+	const auto orbited2 = tree.parents[node2];
+
+	if (orbited1 == -1 || orbited2 == -1)
+		return -1;
+
+	const auto ancestor = get_lowest_common_ancestor(index, orbited1, orbited2);
+
+	if (ancestor == -1)
+		return -1;
+
+	return (index.depths[orbited1] - index.depths[ancestor]) + (index.depths[orbited2] - index.depths[ancestor]);
+}
+
+auto print_shortest_distances(const orbit_tree& tree, const lca_index& index, std::ifstream& queries_file) -> void
+{
+	std::string node1;
+	std::string node2;
+
+	while (queries_file >> node1 >> node2)
+	{
+		const auto distance = get_shortest_distance(tree, index, find_body_id(tree, node1), find_body_id(tree, node2));
+		std::cout << node1 << " -> " << node2 << ": " << distance << std::endl;
+	}
+}
+
+constexpr auto parallel_parse_min_size = std::size_t{1} << 20;
+
+using orbit_edges = std::vector<std::pair<std::string_view, std::string_view>>;
+
+auto parse_orbit_edges(std::string_view text) -> orbit_edges
+{
+	orbit_edges edges;
+
+	for (auto edge = next_token(text); !edge.empty(); edge = next_token(text))
+	{
+		const auto separator_index = edge.find(')');
+		if (separator_index != std::string_view::npos)
+			edges.emplace_back(edge.substr(0, separator_index), edge.substr(separator_index + 1));
+	}
+
+	return edges;
+}
+
+auto split_lines(const std::string_view text, const std::size_t num_chunks) -> std::vector<std::string_view>
+{
+	std::vector<std::string_view> chunks;
+
+	const auto chunk_size = text.size() / num_chunks + 1;
+	auto chunk_start = std::size_t{0};
+
+	while (chunk_start < text.size())
+	{
+		auto chunk_end = std::min(text.size(), chunk_start + chunk_size);
+		while (chunk_end < text.size() && text[chunk_end] != '\n')
+			++chunk_end;
+
+		chunks.push_back(text.substr(chunk_start, chunk_end - chunk_start));
+		chunk_start = chunk_end;
+	}
+
+	return chunks;
+}
+
+auto parse_orbit_edges_in_parallel(const std::string_view text) -> std::vector<orbit_edges>
+{
+	const auto num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+	if (num_threads == 1 || text.size() < parallel_parse_min_size)
+		return {parse_orbit_edges(text)};
+
+	const auto chunks = split_lines(text, num_threads);
+	std::vector<orbit_edges> chunk_edges(chunks.size());
+	std::vector<std::thread> threads;
+
+	for (auto i = std::size_t{0}; i < chunks.size(); ++i)
+		threads.emplace_back([&chunk_edges, &chunks, i] { chunk_edges[i] = parse_orbit_edges(chunks[i]); });
+
+	for (auto& thread : threads)
+		thread.join();
+
+	return chunk_edges;
+}
+
+auto load_orbit_tree(const std::string_view text) -> orbit_tree
+{
+	orbit_tree tree;
+
+	const auto chunk_edges = parse_orbit_edges_in_parallel(text);
+
+	auto num_edges = std::size_t{0};
+	for (const auto& edges : chunk_edges)
+		num_edges += edges.size();
+
+	tree.ids.reserve(num_edges + 1);
+	tree.names.reserve(num_edges + 1);
+	tree.parents.reserve(num_edges + 1);
+
+	for (const auto& edges : chunk_edges)
+	{
+		for (const auto&[parent_name, child_name] : edges)
+		{
+			const auto parent = get_body_id(tree, parent_name);
+			const auto child = get_body_id(tree, child_name);
+			tree.parents[child] = parent;
+		}
+	}
+
+	build_childs(tree);
+
+	return tree;
 }
 
-auto load_orbit_tree(std::ifstream& data_file) -> orbit_tree
+auto load_orbit_tree(std::unique_ptr<mapped_file> file) -> orbit_tree
+{
+	auto tree = load_orbit_tree(file->data());
+	tree.file = std::move(file);
+
+	return tree;
+}
+
+struct dynamic_orbit_map
 {
 	orbit_tree tree;
+	std::deque<std::string> added_names;
+	std::vector<std::vector<int>> childs;
+	std::vector<int> depths;
+	std::vector<int> subtree_sizes;
+	std::int64_t total_orbits;
+};
+
+auto build_dynamic_orbit_map(orbit_tree tree) -> dynamic_orbit_map
+{
+	const auto num_bodies = int(tree.names.size());
+
+	dynamic_orbit_map map{std::move(tree), {}, std::vector<std::vector<int>>(num_bodies), {}, std::vector<int>(num_bodies, 1), 0};
+	map.depths = get_depths(map.tree);
+	map.total_orbits = get_total_orbits(map.depths);
+
+	for (auto body = 0; body < num_bodies; ++body)
+	{
+		const auto& offsets = map.tree.child_offsets;
+		map.childs[body].assign(map.tree.childs.begin() + offsets[body], map.tree.childs.begin() + offsets[body + 1]);
+	}
+
+	std::vector<int> order(num_bodies);
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&map] (const int l, const int r) { return map.depths[l] > map.depths[r]; });
+
+	for (const auto body : order)
+	{
+		const auto parent = map.tree.parents[body];
+		if (parent != -1)
+			map.subtree_sizes[parent] += map.subtree_sizes[body];
+	}
+
+	return map;
+}
+
+auto get_dynamic_body_id(dynamic_orbit_map& map, const std::string_view name) -> int
+{
+	const auto id = find_body_id(map.tree, name);
+	if (id != -1)
+		return id;
+
+	const auto new_id = get_body_id(map.tree, map.added_names.emplace_back(name));
+	map.childs.emplace_back();
+	map.depths.push_back(0);
+	map.subtree_sizes.push_back(1);
+
+	return new_id;
+}
+
+auto shift_subtree_depths(dynamic_orbit_map& map, const int top, const int delta) -> void
+{
+	std::vector<int> pending{top};
+
+	while (!pending.empty())
+	{
+		const auto body = pending.back();
+		pending.pop_back();
+
+		map.depths[body] += delta;
+		pending.insert(pending.end(), map.childs[body].begin(), map.childs[body].end());
+	}
+
+	map.total_orbits += std::int64_t{delta} * map.subtree_sizes[top];
+}
+
+auto add_subtree_size(dynamic_orbit_map& map, int body, const int size) -> void
+{
+	for (; body != -1; body = map.tree.parents[body])
+		map.subtree_sizes[body] += size;
+}
+
+auto detach_orbit(dynamic_orbit_map& map, const int child) -> void
+{
+	const auto parent = map.tree.parents[child];
+	if (parent == -1)
+		return;
+
+	auto& siblings = map.childs[parent];
+	siblings.erase(std::find(siblings.begin(), siblings.end(), child));
+
+	add_subtree_size(map, parent, -map.subtree_sizes[child]);
+	map.tree.parents[child] = -1;
+	shift_subtree_depths(map, child, -map.depths[child]);
+}
 
+auto add_orbit(dynamic_orbit_map& map, const std::string_view parent_name, const std::string_view child_name) -> bool
+{
+	const auto parent = get_dynamic_body_id(map, parent_name);
+	const auto child = get_dynamic_body_id(map, child_name);
+
+	for (auto body = parent; body != -1; body = map.tree.parents[body])
+	{
+		if (body == child)
+			return false;
+	}
+
+	detach_orbit(map, child);
+
+	map.tree.parents[child] = parent;
+	map.childs[parent].push_back(child);
+	add_subtree_size(map, parent, map.subtree_sizes[child]);
+	shift_subtree_depths(map, child, map.depths[parent] + 1 - map.depths[child]);
+
+	return true;
+}
+
+auto remove_orbit(dynamic_orbit_map& map, const std::string_view parent_name, const std::string_view child_name) -> bool
+{
+	const auto parent = find_body_id(map.tree, parent_name);
+	const auto child = find_body_id(map.tree, child_name);
+
+	if (parent == -1 || child == -1 || map.tree.parents[child] != parent)
+		return false;
+
+	detach_orbit(map, child);
+
+	return true;
+}
+
+auto apply_orbit_edits(dynamic_orbit_map& map, std::ifstream& edits_file) -> void
+{
 	std::string line;
-	while (data_file >> line)
+	while (edits_file >> line)
 	{
 		const auto separator_index = line.find(')');
-		const auto parent = line.substr(0, separator_index);
-		tree[parent].push_back(line.substr(separator_index + 1));
+		if (line.size() < 2 || separator_index == std::string::npos)
+		{
+			std::cerr << "Error! Invalid edit: " << line << std::endl;
+			continue;
+		}
+
+		const auto parent = std::string_view(line).substr(1, separator_index - 1);
+		const auto child = std::string_view(line).substr(separator_index + 1);
+
+		auto applied = false;
+		switch (line[0])
+		{
+			case '+':
+				applied = add_orbit(map, parent, child);
+				break;
+			case '-':
+				applied = remove_orbit(map, parent, child);
+				break;
+		}
+
+		if (!applied)
+			std::cerr << "Error! Cannot apply edit: " << line << std::endl;
+
+		std::cout << line << ": total orbits: " << map.total_orbits << std::endl;
 	}
+}
 
-	return tree;
+auto solve(const std::string_view input) -> solution
+{
+	solution result;
+
+	const auto tree = time_phase(result.parse_time, [&] { return load_orbit_tree(input); });
+
+	auto depths = std::vector<int>{};
+
+	result.part1 = time_phase(result.part1_time, [&] {
+		depths = get_depths(tree);
+		return std::to_string(get_total_orbits(depths));
+	});
+
+	result.part2 = time_phase(result.part2_time, [&] {
+		const auto index = build_lca_index(tree, std::move(depths));
+		return std::to_string(get_shortest_distance(tree, index, find_body_id(tree, "YOU"), find_body_id(tree, "SAN")));
+	});
+
+	return result;
 }
 
+} // namespace day6
+
+#ifndef AOC_RUNNER
+using namespace day6;
+
 int main(int argc, char* argv[])
 {
-	if (argc != 2)
+	const auto edits = (argc == 4 && std::string(argv[2]) == "--edits");
+
+	if (argc != 2 && argc != 3 && !edits)
 	{
 		std::cerr << "Error! An input file is required!" << std::endl;
 		return -1;
 	}
 
-	std::ifstream data_file(argv[1]);
+	auto data_file = std::make_unique<mapped_file>(argv[1]);
 
-	if (!data_file.is_open())
+	if (!data_file->is_open())
 	{
 		std::cerr << "Error! Cannot open file: " << argv[1] << std::endl;
 		return -1;
 	}
 
-	auto tree = load_orbit_tree(data_file);
+	auto tree = load_orbit_tree(std::move(data_file));
+
+	if (edits)
+	{
+		std::ifstream edits_file(argv[3]);
+
+		if (!edits_file.is_open())
+		{
+			std::cerr << "Error! Cannot open file: " << argv[3] << std::endl;
+			return -1;
+		}
+
+		auto map = build_dynamic_orbit_map(std::move(tree));
+		apply_orbit_edits(map, edits_file);
+		return 0;
+	}
+
+	const auto index = build_lca_index(tree, get_depths(tree));
 
-	auto total_orbits = 0; 
-	get_total_orbits(tree, "COM", 0, total_orbits);
-	std::cout << "Total orbits: " << total_orbits << std::endl;
+	if (argc == 3)
+	{
+		std::ifstream queries_file(argv[2]);
 
-	auto distance = -1;
-	get_shortest_distance(tree, "COM", 0, "YOU", "SAN", distance);
+		if (!queries_file.is_open())
+		{
+			std::cerr << "Error! Cannot open file: " << argv[2] << std::endl;
+			return -1;
+		}
+
+		print_shortest_distances(tree, index, queries_file);
+		return 0;
+	}
+
+	std::cout << "Total orbits: " << get_total_orbits(index.depths) << std::endl;
+
+	const auto distance = get_shortest_distance(tree, index, find_body_id(tree, "YOU"), find_body_id(tree, "SAN"));
 	std::cout << "Minimum number of orbital transfers: " << distance << std::endl;
-		
+
 	return 0;
 }
+#endif
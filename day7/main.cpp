@@ -1,9 +1,16 @@
 #include <array>
 #include <iostream>
 #include <fstream>
-#include <sstream>
+#include <string>
+#include <string_view>
 #include <vector>
 
+#include "../common/parse.hpp"
+#include "../common/solution.hpp"
+
+namespace day7
+{
+
 constexpr auto show_asm = false;
 
 template<typename Container>
@@ -46,17 +53,9 @@ auto print_computer_state(const computer_state& computer) -> void
 	std::cout << "----------------------" << std::endl;
 }
 
-auto load_program(const std::string& data) -> std::vector<int>
+auto load_program(const std::string_view data) -> std::vector<int>
 {
-	std::vector<int> program;
-
-	std::stringstream ss_data(data);
-	std::string int_data;
-	
-	while (std::getline(ss_data, int_data, ',')) 
-		program.push_back(std::stoi(int_data));
-	
-	return program;
+	return parse_integer_list<int>(data, ',');
 }
 
 constexpr auto immediate_1st_param(int value) -> int
@@ -197,14 +196,14 @@ auto run_program(computer_state& computer, bool return_on_output) -> void
 	}
 }
 
-auto get_thruster_signal_from_sequence(const std::string& sequence, const std::string& program) -> int
+auto get_thruster_signal_from_sequence(const std::string& sequence, const std::vector<int>& program) -> int
 {
 	auto value = 0;
 	
 	for (const auto phase_setting : sequence)
 	{
 		computer_state computer;
-		computer.memory = load_program(program);
+		computer.memory = program;
 		computer.in_data = {int(phase_setting - '0'), value};
 		run_program(computer, false);
 		value = computer.out_data[0];
@@ -213,14 +212,14 @@ auto get_thruster_signal_from_sequence(const std::string& sequence, const std::s
 	return value;
 }
 
-auto init_amplifiers_feedback_loop(const std::string& sequence, const std::string& program) -> std::vector<computer_state>
+auto init_amplifiers_feedback_loop(const std::string& sequence, const std::vector<int>& program) -> std::vector<computer_state>
 {
 	std::vector<computer_state> amplifiers;
 
 	for (const auto phase_setting : sequence)
 	{
 		computer_state computer;
-		computer.memory = load_program(program);
+		computer.memory = program;
 		computer.in_data = {int(phase_setting - '0')};
 		amplifiers.push_back(std::move(computer));
 	}
@@ -228,7 +227,7 @@ auto init_amplifiers_feedback_loop(const std::string& sequence, const std::strin
 	return amplifiers;
 }
 
-auto get_thruster_signal_from_sequence_feedback_loop(const std::string& sequence, const std::string& program) -> int
+auto get_thruster_signal_from_sequence_feedback_loop(const std::string& sequence, const std::vector<int>& program) -> int
 {
 	auto value = 0;
 	auto stop = false;
@@ -276,7 +275,7 @@ auto is_valid_phase_setting_sequence(const std::string& sequence, const char fro
 	return true;
 }
 
-auto get_max_thruster_signal(const std::string& program) -> int
+auto get_max_thruster_signal(const std::vector<int>& program) -> int
 {
 	auto max_thruster = 0;
 	for (auto phase = 100000; phase < 150000; ++phase)
@@ -291,7 +290,7 @@ auto get_max_thruster_signal(const std::string& program) -> int
 	return max_thruster;
 }
 
-auto get_max_thruster_signal_feedback_loop(const std::string& program) -> int
+auto get_max_thruster_signal_feedback_loop(const std::vector<int>& program) -> int
 {
 	auto max_thruster = 0;
 	for (auto phase = 150000; phase < 200000; ++phase)
@@ -306,6 +305,29 @@ auto get_max_thruster_signal_feedback_loop(const std::string& program) -> int
 	return max_thruster;
 }
 
+auto solve(const std::string_view input) -> solution
+{
+	solution result;
+
+	const auto program = time_phase(result.parse_time, [&] {
+		auto data = input;
+		return load_program(next_token(data));
+	});
+
+	if (program.empty())
+		return result;
+
+	result.part1 = time_phase(result.part1_time, [&] { return std::to_string(get_max_thruster_signal(program)); });
+	result.part2 = time_phase(result.part2_time, [&] { return std::to_string(get_max_thruster_signal_feedback_loop(program)); });
+
+	return result;
+}
+
+} // namespace day7
+
+#ifndef AOC_RUNNER
+using namespace day7;
+
 int main(int argc, char* argv[])
 {
 	if (argc < 2)
@@ -325,11 +347,14 @@ int main(int argc, char* argv[])
 	std::string data_program;
 	data_file >> data_program;
 
-	const auto max_thruster = get_max_thruster_signal(data_program);
+	const auto program = load_program(data_program);
+
+	const auto max_thruster = get_max_thruster_signal(program);
 	std::cout << "Max thruster signal: " << max_thruster << std::endl;
 
-	const auto max_thruster_feedback_loop = get_max_thruster_signal_feedback_loop(data_program);
+	const auto max_thruster_feedback_loop = get_max_thruster_signal_feedback_loop(program);
 	std::cout << "Max thruster signal feedback loop: " << max_thruster_feedback_loop << std::endl;
 	
 	return 0;
 }
+#endif
@@ -1,22 +1,166 @@
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
+#include <iterator>
 #include <fstream>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
-constexpr auto output_filename = "image.ppm";
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
-auto get_color_at_pos(const std::vector<std::vector<int>>& image, const int pos) -> int
+#include "../common/solution.hpp"
+
+namespace day8
+{
+
+struct space_image
+{
+	int width;
+	int height;
+	int num_layers;
+	std::vector<std::uint8_t> pixels;
+
+	auto get_layer_size() const -> int
+	{
+		return width * height;
+	}
+
+	auto get_layer(const int index) const -> const std::uint8_t*
+	{
+		return pixels.data() + std::size_t(index) * std::size_t(get_layer_size());
+	}
+};
+
+struct layer_digits
+{
+	int zeros;
+	int ones;
+	int twos;
+};
+
+auto count_layer_digits(const std::uint8_t* layer, const int layer_size) -> layer_digits
+{
+	layer_digits digits{0, 0, 0};
+	auto pos = 0;
+
+#if defined(__AVX2__)
+	const auto zero = _mm256_set1_epi8(0);
+	const auto one = _mm256_set1_epi8(1);
+	const auto two = _mm256_set1_epi8(2);
+
+	for (; pos + 32 <= layer_size; pos += 32)
+	{
+		const auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(layer + pos));
+		digits.zeros += __builtin_popcount(unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, zero))));
+		digits.ones += __builtin_popcount(unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, one))));
+		digits.twos += __builtin_popcount(unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, two))));
+	}
+#endif
+
+	for (; pos < layer_size; ++pos)
+	{
+		digits.zeros += layer[pos] == 0;
+		digits.ones += layer[pos] == 1;
+		digits.twos += layer[pos] == 2;
+	}
+
+	return digits;
+}
+
+auto blend_layer(std::uint8_t* composite, const std::uint8_t* layer, const int layer_size) -> int
+{
+	auto transparent = 0;
+	auto pos = 0;
+
+#if defined(__AVX2__)
+	const auto two = _mm256_set1_epi8(2);
+
+	for (; pos + 32 <= layer_size; pos += 32)
+	{
+		auto* composite_block = reinterpret_cast<__m256i*>(composite + pos);
+		const auto pixels = _mm256_loadu_si256(composite_block);
+		const auto layer_pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(layer + pos));
+		const auto blended = _mm256_blendv_epi8(pixels, layer_pixels, _mm256_cmpeq_epi8(pixels, two));
+
+		_mm256_storeu_si256(composite_block, blended);
+		transparent += __builtin_popcount(unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(blended, two))));
+	}
+#endif
+
+	for (; pos < layer_size; ++pos)
+	{
+		const auto pixel = composite[pos];
+		composite[pos] = pixel == 2 ? layer[pos] : pixel;
+		transparent += composite[pos] == 2;
+	}
+
+	return transparent;
+}
+
+auto composite_layers(const space_image& image) -> std::vector<std::uint8_t>
 {
-	for (const auto& layer : image)
+	const auto layer_size = image.get_layer_size();
+	std::vector<std::uint8_t> composite(std::size_t(layer_size), 2);
+
+	for (auto i = 0; i < image.num_layers; ++i)
+	{
+		if (blend_layer(composite.data(), image.get_layer(i), layer_size) == 0)
+			break;
+	}
+
+	return composite;
+}
+
+enum class image_format
+{
+	p3,
+	p6,
+	pgm,
+	png
+};
+
+auto get_image_format(const std::string_view name) -> std::optional<image_format>
+{
+	if (name == "p3")
+		return image_format::p3;
+	if (name == "p6")
+		return image_format::p6;
+	if (name == "pgm")
+		return image_format::pgm;
+	if (name == "png")
+		return image_format::png;
+	return std::nullopt;
+}
+
+auto get_image_extension(const image_format format) -> const char*
+{
+	switch (format)
 	{
-		const auto color = layer[pos];
-		if (color != 2)
-			return color;
-	}	
-	return 2;
+		case image_format::pgm:
+			return ".pgm";
+		case image_format::png:
+			return ".png";
+		default:
+			return ".ppm";
+	}
 }
 
-auto space_color_to_ppm(const int color) -> std::string
+auto get_default_output_filename(const image_format format) -> std::string
+{
+	return std::string("image") + get_image_extension(format);
+}
+
+auto space_color_to_ppm(const int color) -> std::string_view
 {
 	switch (color)
 	{
@@ -29,78 +173,568 @@ auto space_color_to_ppm(const int color) -> std::string
 	}
 }
 
-auto space_image_to_ppm(const std::vector<std::vector<int>>& image, const int width, const int height) -> void
+auto space_color_to_rgb(const int color) -> std::array<std::uint8_t, 3>
+{
+	switch (color)
+	{
+		case 0:
+			return {0, 0, 0};
+		case 1:
+			return {255, 255, 255};
+		default:
+			return {0, 0, 255};
+	}
+}
+
+auto space_color_to_grey(const int color) -> std::uint8_t
+{
+	switch (color)
+	{
+		case 0:
+			return 0;
+		case 1:
+			return 255;
+		default:
+			return 128;
+	}
+}
+
+auto append(std::vector<std::uint8_t>& buffer, const std::string_view text) -> void
 {
-	std::ofstream ppm_file(output_filename);
-	ppm_file << "P3\n";
-	ppm_file << width << " " << height << " 255\n";
+	buffer.insert(buffer.end(), text.begin(), text.end());
+}
+
+auto get_netpbm_header(const char* magic, const int width, const int height) -> std::string
+{
+	return std::string(magic) + "\n" + std::to_string(width) + " " + std::to_string(height) + " 255\n";
+}
+
+auto encode_p3(const std::vector<std::uint8_t>& composite, const int width, const int height) -> std::vector<std::uint8_t>
+{
+	const auto header = get_netpbm_header("P3", width, height);
+
+	std::vector<std::uint8_t> buffer;
+	buffer.reserve(header.size() + std::size_t(height) * (std::size_t(width) * 12 + 1));
+	append(buffer, header);
 
 	for (auto y = 0; y < height; ++y)
 	{
 		for (auto x = 0; x < width; ++x)
 		{
-			const auto pos = y * width + x;
-			const auto color = get_color_at_pos(image, pos);
-			ppm_file << space_color_to_ppm(color) << " ";
+			append(buffer, space_color_to_ppm(composite[y * width + x]));
+			buffer.push_back(' ');
 		}
-		ppm_file << "\n";
+		buffer.push_back('\n');
 	}
+
+	return buffer;
 }
 
-auto load_space_image(const std::string& data_image, const int width, const int height) -> std::vector<std::vector<int>>
+auto encode_p6(const std::vector<std::uint8_t>& composite, const int width, const int height) -> std::vector<std::uint8_t>
 {
-	std::vector<std::vector<int>> image;
+	const auto header = get_netpbm_header("P6", width, height);
 
-	const auto layer_size = width * height;
+	std::vector<std::uint8_t> buffer(header.begin(), header.end());
+	buffer.reserve(header.size() + composite.size() * 3);
+
+	for (const auto color : composite)
+	{
+		const auto rgb = space_color_to_rgb(color);
+		buffer.insert(buffer.end(), rgb.begin(), rgb.end());
+	}
+
+	return buffer;
+}
+
+auto encode_pgm(const std::vector<std::uint8_t>& composite, const int width, const int height) -> std::vector<std::uint8_t>
+{
+	const auto header = get_netpbm_header("P5", width, height);
+
+	std::vector<std::uint8_t> buffer(header.begin(), header.end());
+	buffer.reserve(header.size() + composite.size());
+
+	for (const auto color : composite)
+		buffer.push_back(space_color_to_grey(color));
+
+	return buffer;
+}
+
+auto get_crc32_table() -> const std::array<std::uint32_t, 256>&
+{
+	static const auto table = [] {
+		std::array<std::uint32_t, 256> crc_table{};
+		for (auto n = std::uint32_t{0}; n < 256; ++n)
+		{
+			auto c = n;
+			for (auto k = 0; k < 8; ++k)
+				c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+			crc_table[n] = c;
+		}
+		return crc_table;
+	}();
+	return table;
+}
+
+auto get_crc32(const std::uint8_t* data, const std::size_t size) -> std::uint32_t
+{
+	const auto& table = get_crc32_table();
+
+	auto crc = 0xffffffffu;
+	for (auto i = std::size_t{0}; i < size; ++i)
+		crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
 
-	auto current_layer_index = 0;
-	image.emplace_back();
+	return crc ^ 0xffffffffu;
+}
+
+auto get_adler32(const std::vector<std::uint8_t>& data) -> std::uint32_t
+{
+	constexpr auto adler_modulo = std::uint32_t{65521};
+	constexpr auto adler_block = std::size_t{5552};
 
-	for (const auto data_value : data_image)
+	auto a = std::uint32_t{1};
+	auto b = std::uint32_t{0};
+
+	for (auto block_start = std::size_t{0}; block_start < data.size(); block_start += adler_block)
 	{
-		if (current_layer_index == layer_size)
+		const auto block_end = std::min(data.size(), block_start + adler_block);
+		for (auto i = block_start; i < block_end; ++i)
 		{
-			image.emplace_back();
-			current_layer_index = 0;
+			a += data[i];
+			b += a;
 		}
-	
-		image.back().push_back(int(data_value - '0'));
-		++current_layer_index;
+		a %= adler_modulo;
+		b %= adler_modulo;
 	}
 
+	return (b << 16) | a;
+}
+
+auto append_big_endian(std::vector<std::uint8_t>& buffer, const std::uint32_t value) -> void
+{
+	buffer.push_back(std::uint8_t(value >> 24));
+	buffer.push_back(std::uint8_t(value >> 16));
+	buffer.push_back(std::uint8_t(value >> 8));
+	buffer.push_back(std::uint8_t(value));
+}
+
+auto append_png_chunk(std::vector<std::uint8_t>& buffer, const std::string_view type, const std::vector<std::uint8_t>& data) -> void
+{
+	append_big_endian(buffer, std::uint32_t(data.size()));
+
+	const auto type_start = buffer.size();
+	append(buffer, type);
+	buffer.insert(buffer.end(), data.begin(), data.end());
+
+	append_big_endian(buffer, get_crc32(buffer.data() + type_start, buffer.size() - type_start));
+}
+
+auto encode_png(const std::vector<std::uint8_t>& composite, const int width, const int height) -> std::vector<std::uint8_t>
+{
+	constexpr auto max_stored_block = std::size_t{65535};
+
+	std::vector<std::uint8_t> scanlines;
+	scanlines.reserve(std::size_t(height) * (std::size_t(width) * 3 + 1));
+
+	for (auto y = 0; y < height; ++y)
+	{
+		scanlines.push_back(0);
+		for (auto x = 0; x < width; ++x)
+		{
+			const auto rgb = space_color_to_rgb(composite[y * width + x]);
+			scanlines.insert(scanlines.end(), rgb.begin(), rgb.end());
+		}
+	}
+
+	const auto num_blocks = std::max(std::size_t{1}, (scanlines.size() + max_stored_block - 1) / max_stored_block);
+
+	std::vector<std::uint8_t> zlib_stream{0x78, 0x01};
+	zlib_stream.reserve(scanlines.size() + num_blocks * 5 + 6);
+
+	for (auto block = std::size_t{0}; block < num_blocks; ++block)
+	{
+		const auto block_start = block * max_stored_block;
+		const auto block_size = std::min(max_stored_block, scanlines.size() - block_start);
+
+		zlib_stream.push_back(block + 1 == num_blocks ? 1 : 0);
+		zlib_stream.push_back(std::uint8_t(block_size));
+		zlib_stream.push_back(std::uint8_t(block_size >> 8));
+		zlib_stream.push_back(std::uint8_t(~block_size));
+		zlib_stream.push_back(std::uint8_t(~block_size >> 8));
+		zlib_stream.insert(zlib_stream.end(), scanlines.begin() + block_start, scanlines.begin() + block_start + block_size);
+	}
+	append_big_endian(zlib_stream, get_adler32(scanlines));
+
+	std::vector<std::uint8_t> header;
+	append_big_endian(header, std::uint32_t(width));
+	append_big_endian(header, std::uint32_t(height));
+	header.insert(header.end(), {8, 2, 0, 0, 0});
+
+	std::vector<std::uint8_t> buffer{0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+	buffer.reserve(zlib_stream.size() + 64);
+
+	append_png_chunk(buffer, "IHDR", header);
+	append_png_chunk(buffer, "IDAT", zlib_stream);
+	append_png_chunk(buffer, "IEND", {});
+
+	return buffer;
+}
+
+auto encode_space_image(const std::vector<std::uint8_t>& composite, const int width, const int height, const image_format format) ->
+	std::vector<std::uint8_t>
+{
+	switch (format)
+	{
+		case image_format::p6:
+			return encode_p6(composite, width, height);
+		case image_format::pgm:
+			return encode_pgm(composite, width, height);
+		case image_format::png:
+			return encode_png(composite, width, height);
+		default:
+			return encode_p3(composite, width, height);
+	}
+}
+
+auto write_image_file(const std::string& filename, const std::vector<std::uint8_t>& buffer) -> bool
+{
+	std::ofstream image_file(filename, std::ios::binary);
+	image_file.write(reinterpret_cast<const char*>(buffer.data()), std::streamsize(buffer.size()));
+	return bool(image_file);
+}
+
+auto pack_space_image_digits(space_image& image) -> void
+{
+	auto size = std::size_t{0};
+	for (const auto data_value : image.pixels)
+	{
+		const auto digit = std::uint8_t(data_value - '0');
+		if (digit <= 9)
+			image.pixels[size++] = digit;
+	}
+
+	const auto layer_size = std::size_t(image.get_layer_size());
+	image.num_layers = layer_size == 0 ? 0 : int(size / layer_size);
+	image.pixels.resize(std::size_t(image.num_layers) * layer_size);
+}
+
+auto load_space_image(const std::string_view data, const int width, const int height) -> space_image
+{
+	space_image image{width, height, 0, std::vector<std::uint8_t>(data.begin(), data.end())};
+	pack_space_image_digits(image);
+	return image;
+}
+
+auto load_space_image(std::ifstream& data_file, const int width, const int height) -> space_image
+{
+	space_image image{width, height, 0, {}};
+
+	image.pixels.assign(std::istreambuf_iterator<char>(data_file), std::istreambuf_iterator<char>());
+	pack_space_image_digits(image);
+
 	return image;
 }
 
-auto get_fewest_zero_digits_layer_index(const std::vector<std::vector<int>>& image) -> int
+auto get_fewest_zero_digits_layer(const space_image& image) -> layer_digits
+{
+	layer_digits fewest_zero_digits{std::numeric_limits<int>::max(), 0, 0};
+
+	for (auto i = 0; i < image.num_layers; ++i)
+	{
+		const auto digits = count_layer_digits(image.get_layer(i), image.get_layer_size());
+
+		if (digits.zeros < fewest_zero_digits.zeros)
+			fewest_zero_digits = digits;
+	}
+
+	return fewest_zero_digits;
+}
+
+constexpr auto stream_chunk_size = std::size_t{1} << 16;
+
+struct decoded_space_image
+{
+	int num_layers;
+	layer_digits fewest_zero_digits;
+	std::vector<std::uint8_t> composite;
+};
+
+auto decode_space_image(const space_image& image) -> decoded_space_image
+{
+	return {image.num_layers, get_fewest_zero_digits_layer(image), composite_layers(image)};
+}
+
+auto decode_space_image_stream(std::istream& data_file, const int width, const int height) -> decoded_space_image
+{
+	const auto layer_size = width * height;
+
+	decoded_space_image decoded{0, {std::numeric_limits<int>::max(), 0, 0}, std::vector<std::uint8_t>(std::size_t(layer_size), 2)};
+
+	auto layer = std::vector<std::uint8_t>(std::size_t(layer_size));
+	std::vector<char> chunk(stream_chunk_size);
+
+	auto layer_pos = 0;
+	auto transparent = layer_size;
+
+	while (data_file.read(chunk.data(), std::streamsize(chunk.size())) || data_file.gcount() > 0)
+	{
+		const auto chunk_end = chunk.begin() + data_file.gcount();
+
+		for (auto it = chunk.begin(); it != chunk_end; ++it)
+		{
+			const auto digit = std::uint8_t(*it - '0');
+			if (digit > 9)
+				continue;
+
+			layer[layer_pos++] = digit;
+			if (layer_pos != layer_size)
+				continue;
+
+			const auto digits = count_layer_digits(layer.data(), layer_size);
+			if (digits.zeros < decoded.fewest_zero_digits.zeros)
+				decoded.fewest_zero_digits = digits;
+
+			if (transparent != 0)
+				transparent = blend_layer(decoded.composite.data(), layer.data(), layer_size);
+
+			++decoded.num_layers;
+			layer_pos = 0;
+		}
+	}
+
+	return decoded;
+}
+
+auto get_checksum(const decoded_space_image& decoded) -> std::int64_t
+{
+	return std::int64_t{decoded.fewest_zero_digits.ones} * decoded.fewest_zero_digits.twos;
+}
+
+struct decode_options
+{
+	image_format format = image_format::p3;
+	bool stream = false;
+	std::optional<std::string> output_filename;
+};
+
+auto parse_decode_options(const int argc, char* argv[], const int first, decode_options& options) -> bool
+{
+	for (auto i = first; i < argc; ++i)
+	{
+		const auto option = std::string_view(argv[i]);
+
+		if (option.substr(0, 9) == "--format=")
+		{
+			const auto selected_format = get_image_format(option.substr(9));
+			if (!selected_format)
+			{
+				std::cerr << "Error! Unknown image format: " << option.substr(9) << std::endl;
+				return false;
+			}
+			options.format = *selected_format;
+		}
+		else if (option.substr(0, 9) == "--output=")
+			options.output_filename = std::string(option.substr(9));
+		else if (option == "--stream")
+			options.stream = true;
+		else
+		{
+			std::cerr << "Error! Unknown option: " << option << std::endl;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+struct batch_image
+{
+	std::string filename;
+	int width;
+	int height;
+	std::string output_filename;
+};
+
+struct batch_result
+{
+	std::optional<std::int64_t> checksum;
+	std::string error;
+};
+
+auto load_batch_manifest(std::ifstream& manifest_file, const image_format format) -> std::vector<batch_image>
+{
+	std::vector<batch_image> images;
+
+	std::string line;
+	while (std::getline(manifest_file, line))
+	{
+		std::stringstream ss_line(line);
+		batch_image image{"", 0, 0, ""};
+
+		if (!(ss_line >> image.filename >> image.width >> image.height))
+			continue;
+
+		if (!(ss_line >> image.output_filename))
+			image.output_filename = image.filename + get_image_extension(format);
+
+		images.push_back(std::move(image));
+	}
+
+	return images;
+}
+
+auto decode_batch_image(const batch_image& image, const image_format format) -> batch_result
+{
+	if (image.width <= 0 || image.height <= 0)
+		return {std::nullopt, "width and height must be positive"};
+
+	std::ifstream data_file(image.filename, std::ios::binary);
+
+	if (!data_file.is_open())
+		return {std::nullopt, "cannot open file"};
+
+	const auto decoded = decode_space_image_stream(data_file, image.width, image.height);
+
+	if (decoded.num_layers == 0)
+		return {std::nullopt, "the image has no complete layer"};
+
+	if (!write_image_file(image.output_filename, encode_space_image(decoded.composite, image.width, image.height, format)))
+		return {std::nullopt, "cannot write file " + image.output_filename};
+
+	return {get_checksum(decoded), ""};
+}
+
+auto decode_batch(const std::vector<batch_image>& images, const image_format format) -> std::vector<batch_result>
+{
+	std::vector<batch_result> results(images.size());
+
+	std::atomic<std::size_t> next_image{0};
+	const auto worker = [&] {
+		for (auto i = next_image++; i < images.size(); i = next_image++)
+			results[i] = decode_batch_image(images[i], format);
+	};
+
+	const auto num_threads = std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()), images.size());
+	std::vector<std::thread> threads;
+	for (auto i = std::size_t{1}; i < num_threads; ++i)
+		threads.emplace_back(worker);
+
+	worker();
+
+	for (auto& thread : threads)
+		thread.join();
+
+	return results;
+}
+
+auto run_batch(const char* manifest_filename, const decode_options& options) -> int
 {
-	auto layer_index = -1;
-	auto fewest_zero_digits = std::numeric_limits<int>::max();
+	std::ifstream manifest_file(manifest_filename);
 
-	const auto image_size = int(image.size());
-	
-	for (auto i = 0; i < image_size; ++i)
+	if (!manifest_file.is_open())
 	{
-		const auto zero_digits = std::count(image[i].begin(), image[i].end(), 0);
+		std::cerr << "Error! Cannot open file: " << manifest_filename << std::endl;
+		return -1;
+	}
+
+	const auto images = load_batch_manifest(manifest_file, options.format);
+	const auto results = decode_batch(images, options.format);
 
-		if (zero_digits < fewest_zero_digits)
+	auto failed = false;
+	for (auto i = std::size_t{0}; i < images.size(); ++i)
+	{
+		if (results[i].checksum)
+			std::cout << images[i].filename << ": 1 digits * 2 digits: " << *results[i].checksum << " -> " << images[i].output_filename << std::endl;
+		else
 		{
-			layer_index = i;
-			fewest_zero_digits = zero_digits;
+			std::cerr << "Error! " << images[i].filename << ": " << results[i].error << std::endl;
+			failed = true;
 		}
 	}
 
-	return layer_index;
+	return failed ? -1 : 0;
 }
 
+constexpr auto password_image_width = 25;
+constexpr auto password_image_height = 6;
+
+auto render_space_image(const std::vector<std::uint8_t>& composite, const int width, const int height) -> std::string
+{
+	std::string rendered;
+
+	for (auto y = 0; y < height; ++y)
+	{
+		if (y != 0)
+			rendered += '\n';
+
+		for (auto x = 0; x < width; ++x)
+			rendered += composite[std::size_t(y) * std::size_t(width) + std::size_t(x)] == 1 ? '#' : ' ';
+	}
+
+	return rendered;
+}
+
+auto solve(const std::string_view input) -> solution
+{
+	solution result;
+
+	const auto image = time_phase(result.parse_time, [&] {
+		return load_space_image(input, password_image_width, password_image_height);
+	});
+
+	if (image.num_layers == 0)
+		return result;
+
+	result.part1 = time_phase(result.part1_time, [&] {
+		const auto digits = get_fewest_zero_digits_layer(image);
+		return std::to_string(std::int64_t{digits.ones} * digits.twos);
+	});
+
+	result.part2 = time_phase(result.part2_time, [&] {
+		return render_space_image(composite_layers(image), image.width, image.height);
+	});
+
+	return result;
+}
+
+} // namespace day8
+
+#ifndef AOC_RUNNER
+using namespace day8;
+
 int main(int argc, char* argv[])
 {
-	if (argc != 4)
+	if (argc >= 3 && std::string_view(argv[1]) == "--batch")
+	{
+		decode_options options;
+		if (!parse_decode_options(argc, argv, 3, options))
+			return -1;
+
+		if (options.output_filename)
+		{
+			std::cerr << "Error! --output= cannot be used with --batch, give each output file in the manifest instead!" << std::endl;
+			return -1;
+		}
+
+		if (options.stream)
+		{
+			std::cerr << "Error! --stream cannot be used with --batch, batch images are always streamed!" << std::endl;
+			return -1;
+		}
+
+		return run_batch(argv[2], options);
+	}
+
+	if (argc < 4)
 	{
 		std::cerr << "Error! And input file and width and height are required!" << std::endl;
 		return -1;
 	}
 
-	std::ifstream data_file(argv[1]);
+	decode_options options;
+	if (!parse_decode_options(argc, argv, 4, options))
+		return -1;
+
+	std::ifstream data_file(argv[1], std::ios::binary);
 
 	if (!data_file.is_open())
 	{
@@ -108,22 +742,35 @@ int main(int argc, char* argv[])
 		return -1;
 	}
 
-	std::string data_image;
-	data_file >> data_image;
-
 	const auto width = std::atoi(argv[2]);
 	const auto height = std::atoi(argv[3]);
 
-	const auto image = load_space_image(data_image, width, height);
+	if (width <= 0 || height <= 0)
+	{
+		std::cerr << "Error! Width and height must be positive!" << std::endl;
+		return -1;
+	}
 
-	const auto fewest_zero_digits_layer = image[get_fewest_zero_digits_layer_index(image)];
+	const auto decoded = options.stream ? decode_space_image_stream(data_file, width, height)
+										: decode_space_image(load_space_image(data_file, width, height));
 
-	const auto one_digits = std::count(fewest_zero_digits_layer.begin(), fewest_zero_digits_layer.end(), 1);
-	const auto two_digits = std::count(fewest_zero_digits_layer.begin(), fewest_zero_digits_layer.end(), 2);
+	if (decoded.num_layers == 0)
+	{
+		std::cerr << "Error! The image has no complete layer: " << argv[1] << std::endl;
+		return -1;
+	}
+
+	std::cout << "Fewest 0 digits layer, 1 digits * 2 digits: " << get_checksum(decoded) << std::endl;
 
-	std::cout << "Fewest 0 digits layer, 1 digits * 2 digits: " << (one_digits * two_digits) << std::endl;
+	const auto filename = options.output_filename.value_or(get_default_output_filename(options.format));
+	const auto buffer = encode_space_image(decoded.composite, width, height, options.format);
+
+	if (!write_image_file(filename, buffer))
+	{
+		std::cerr << "Error! Cannot write file: " << filename << std::endl;
+		return -1;
+	}
 
-	space_image_to_ppm(image, width, height);
-			
 	return 0;
 }
+#endif
@@ -2,9 +2,16 @@
 #include <cmath>
 #include <iostream>
 #include <fstream>
-#include <sstream>
+#include <string>
+#include <string_view>
 #include <vector>
 
+#include "../common/parse.hpp"
+#include "../common/solution.hpp"
+
+namespace day9
+{
+
 constexpr auto show_asm = false;
 
 using int64 = long long;
@@ -57,17 +64,9 @@ auto print_computer_state(const computer_state& computer, const bool print_memor
 	std::cout << "----------------------" << std::endl;
 }
 
-auto load_program(const std::string& data) -> std::vector<int64>
+auto load_program(const std::string_view data) -> std::vector<int64>
 {
-	std::vector<int64> program;
-
-	std::stringstream ss_data(data);
-	std::string int_data;
-	
-	while (std::getline(ss_data, int_data, ',')) 
-		program.push_back(std::stoll(int_data));
-	
-	return program;
+	return parse_integer_list<int64>(data, ',');
 }
 
 auto get_address(const computer_state& computer, const int param_number) -> int64
@@ -250,6 +249,40 @@ auto run_program(computer_state& computer, bool return_on_output) -> void
 	}
 }
 
+auto get_boost_output(const std::vector<int64>& program, const int64 mode) -> std::string
+{
+	computer_state computer;
+	computer.memory = program;
+	computer.in_data = {mode};
+
+	run_program(computer, false);
+
+	return computer.out_data.empty() ? std::string("none") : std::to_string(computer.out_data[0]);
+}
+
+auto solve(const std::string_view input) -> solution
+{
+	solution result;
+
+	const auto program = time_phase(result.parse_time, [&] {
+		auto data = input;
+		return load_program(next_token(data));
+	});
+
+	if (program.empty())
+		return result;
+
+	result.part1 = time_phase(result.part1_time, [&] { return get_boost_output(program, 1); });
+	result.part2 = time_phase(result.part2_time, [&] { return get_boost_output(program, 2); });
+
+	return result;
+}
+
+} // namespace day9
+
+#ifndef AOC_RUNNER
+using namespace day9;
+
 int main(int argc, char* argv[])
 {
 	if (argc < 2)
@@ -285,3 +318,4 @@ int main(int argc, char* argv[])
 	
 	return 0;
 }
+#endif
@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../common/mapped_file.hpp"
+#include "../common/solution.hpp"
+#include "solvers.hpp"
+
+using solver_function = auto (*)(std::string_view input) -> solution;
+
+constexpr std::array<solver_function, 10> solvers{
+	day1::solve, day2::solve, day3::solve, day4::solve, day5::solve,
+	day6::solve, day7::solve, day8::solve, day9::solve, day10::solve
+};
+
+using input_cache = std::unordered_map<std::string, std::unique_ptr<mapped_file>>;
+
+auto get_input(input_cache& cache, const std::string& filename) -> const mapped_file*
+{
+	auto& file = cache[filename];
+	if (!file)
+		file = std::make_unique<mapped_file>(filename.c_str());
+
+	return file->is_open() ? file.get() : nullptr;
+}
+
+auto get_input_filename(const std::string& input_directory, const int day) -> std::string
+{
+	return input_directory + "/day" + std::to_string(day) + ".txt";
+}
+
+struct day_run
+{
+	int day;
+	const mapped_file* input;
+	solution result;
+};
+
+auto run_days(std::vector<day_run>& runs, const bool parallel) -> void
+{
+	const auto num_runs = runs.size();
+	const auto num_threads = parallel ? std::max(1u, std::min(std::thread::hardware_concurrency(), unsigned(num_runs))) : 1u;
+
+	std::atomic<std::size_t> next{0};
+	const auto worker = [&] {
+		for (auto i = next++; i < num_runs; i = next++)
+			runs[i].result = solvers[runs[i].day - 1](runs[i].input->data());
+	};
+
+	std::vector<std::thread> threads;
+	for (auto i = 1u; i < num_threads; ++i)
+		threads.emplace_back(worker);
+
+	worker();
+
+	for (auto& thread : threads)
+		thread.join();
+}
+
+auto get_milliseconds(const std::chrono::steady_clock::duration duration) -> double
+{
+	return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+auto print_answer(const char* part, const std::string& answer) -> void
+{
+	std::cout << "  " << part << ":";
+
+	if (answer.empty())
+	{
+		std::cout << " none" << std::endl;
+		return;
+	}
+
+	if (answer.find('\n') == std::string::npos)
+	{
+		std::cout << " " << answer << std::endl;
+		return;
+	}
+
+	std::cout << std::endl;
+
+	std::size_t begin = 0;
+	while (begin <= answer.size())
+	{
+		const auto end = std::min(answer.find('\n', begin), answer.size());
+		std::cout << "    " << std::string_view(answer).substr(begin, end - begin) << std::endl;
+		begin = end + 1;
+	}
+}
+
+auto print_day_run(const day_run& run) -> void
+{
+	const auto& result = run.result;
+
+	std::cout << "Day " << run.day << " (parse " << get_milliseconds(result.parse_time) << " ms, part 1 "
+			  << get_milliseconds(result.part1_time) << " ms, part 2 " << get_milliseconds(result.part2_time) << " ms)" << std::endl;
+
+	print_answer("Part 1", result.part1);
+	print_answer("Part 2", result.part2);
+}
+
+int main(int argc, char* argv[])
+{
+	const auto parallel = (argc >= 2 && std::string_view(argv[1]) == "--parallel");
+	const auto first_arg = parallel ? 2 : 1;
+
+	if (argc <= first_arg)
+	{
+		std::cerr << "Error! An input directory is required!" << std::endl;
+		return -1;
+	}
+
+	const std::string input_directory(argv[first_arg]);
+
+	std::vector<int> days;
+	for (auto i = first_arg + 1; i < argc; ++i)
+	{
+		const auto day = std::atoi(argv[i]);
+		if (day < 1 || day > int(solvers.size()))
+		{
+			std::cerr << "Error! Unknown day: " << argv[i] << std::endl;
+			return -1;
+		}
+		days.push_back(day);
+	}
+
+	const auto all_days = days.empty();
+	if (all_days)
+	{
+		for (auto day = 1; day <= int(solvers.size()); ++day)
+			days.push_back(day);
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+
+	input_cache cache;
+	std::vector<day_run> runs;
+
+	for (const auto day : days)
+	{
+		const auto filename = get_input_filename(input_directory, day);
+		const auto* input = get_input(cache, filename);
+
+		if (input == nullptr)
+		{
+			if (!all_days)
+			{
+				std::cerr << "Error! Cannot open file: " << filename << std::endl;
+				return -1;
+			}
+			continue;
+		}
+
+		runs.push_back({day, input, {}});
+	}
+
+	const auto loaded = std::chrono::steady_clock::now();
+
+	run_days(runs, parallel);
+
+	const auto finished = std::chrono::steady_clock::now();
+
+	std::cout << std::fixed << std::setprecision(3);
+
+	for (const auto& run : runs)
+		print_day_run(run);
+
+	std::cout << "Input load: " << get_milliseconds(loaded - start) << " ms" << std::endl;
+	std::cout << "Total: " << get_milliseconds(finished - start) << " ms" << std::endl;
+
+	return 0;
+}
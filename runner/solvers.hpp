@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string_view>
+
+#include "../common/solution.hpp"
+
+namespace day1 { auto solve(std::string_view input) -> solution; }
+namespace day2 { auto solve(std::string_view input) -> solution; }
+namespace day3 { auto solve(std::string_view input) -> solution; }
+namespace day4 { auto solve(std::string_view input) -> solution; }
+namespace day5 { auto solve(std::string_view input) -> solution; }
+namespace day6 { auto solve(std::string_view input) -> solution; }
+namespace day7 { auto solve(std::string_view input) -> solution; }
+namespace day8 { auto solve(std::string_view input) -> solution; }
+namespace day9 { auto solve(std::string_view input) -> solution; }
+namespace day10 { auto solve(std::string_view input) -> solution; }